@@ -13,6 +13,7 @@
 
 #include "stdint.h"
 #include "stdbool.h"
+#include "stddef.h"
 
 #ifndef __FILE_NAME__
 #include <string.h>
@@ -25,6 +26,7 @@
                                     if (!(expr))    \
                                     {               \
                                         flog_printf(false, "[%s:%d] %s\r\n", __FILE_NAME__, __LINE__, #expr);\
+                                        FLOG_ASSERT_FLUSH();\
                                         while (1);  \
                                     }               \
                                 }while(0);
@@ -35,8 +37,86 @@
 #define FLEXILOG_FILE_NAME_MAX_LENGTH 20     /* 文件名最大长度 */
 #define FLEXILOG_FUNCTION_NAME_MAX_LENGTH 40 /* 函数名最大长度 */
 #define FLEXILOG_TAG_MAX_LENGTH 16           /* 标签最大长度 */
-#define FLEXILOG_TAG_FILTER_NUM  5           /* tag过滤数量 @note 0表示关闭tag过滤 */
+#define FLEXILOG_TAG_FILTER_NUM  5           /* 可注册的tag数量 @note 0表示关闭tag过滤, tag按哈希查找, 数量可以设置到上百个 */
+#define FLEXILOG_TAG_RULE_NODE_NUM 16       /* tag过滤规则节点数量 @note "net.tcp"占用2个节点, 前缀相同的规则共用节点, 删除规则后回收节点 */
 #define FLEXILOG_USE_RING_BUFFER             /* 是否使用环形缓冲区来记录日志 */
+//#define FLEXILOG_USE_ASYNC_OUTPUT            /* 是否使用异步输出 @note 日志先写入异步队列, 由后台任务调用flog_async_process()输出到硬件 */
+//#define FLEXILOG_USE_THREAD_CONTEXT          /* 是否每个线程使用独立的格式化缓冲区 @note 格式化不再加锁, 锁只保护写入缓冲区和硬件输出 */
+//#define FLEXILOG_USE_BUILTIN_FORMAT          /* 是否使用内置格式化代替vsnprintf @note 支持%d %i %u %o %x %X %c %s %p %f和宽度/精度, 不依赖libc的stdio和locale, %e %g按%f输出 */
+//#define FLEXILOG_USE_NUMERIC_TIME            /* 是否使用数值时间 @note 由flog_port_get_ticks()提供tick, 秒以上部分缓存在格式化上下文中, 同一秒内只重新渲染秒以下的数字 */
+//#define FLEXILOG_USE_SINK                    /* 是否使用多个输出器 @note 每个输出器有自己的输出函数, 最低等级, tag掩码和格式, flog_port_output()为0号输出器 */
+//#define FLEXILOG_USE_OUTPUT_BATCH            /* 是否合并硬件输出 @note 日志先暂存在输出缓冲区, 达到阈值, 超过期限, 调用flog_flush()或遇到高等级日志时一次调用flog_port_output()输出 */
+
+/* 编译等级配置 */
+#ifndef FLEXILOG_COMPILE_LEVEL
+#define FLEXILOG_COMPILE_LEVEL 0             /* 编译等级 @note 低于该等级的日志宏编译为空, 参数不会求值, 0:DEBUG 1:INFO 2:WARN 3:ERROR 4:RECORD 5:ASSERT 6:全部移除 */
+#endif
+#if (FLEXILOG_COMPILE_LEVEL < 0) || (FLEXILOG_COMPILE_LEVEL > 6)
+#error "FLEXILOG_COMPILE_LEVEL must be between 0 and 6"
+#endif
+
+/* 线程上下文配置 */
+#ifdef FLEXILOG_USE_THREAD_CONTEXT
+#define FLEXILOG_THREAD_LOCAL _Thread_local  /* 线程局部存储关键字 @note 编译器不支持时注释掉, 由flog_port_get_context()提供每个线程的上下文 */
+//#define FLEXILOG_USE_THREAD_NAME_CACHE      /* 是否缓存线程名 @note 每个线程第一次输出时调用flog_port_get_thread()并缓存在上下文中, 也可以用flog_set_thread_name()命名 */
+#ifdef FLEXILOG_USE_THREAD_NAME_CACHE
+#define FLEXILOG_THREAD_NAME_MAX_LENGTH 24   /* 线程名最大长度 */
+#endif // FLEXILOG_USE_THREAD_NAME_CACHE
+#endif // FLEXILOG_USE_THREAD_CONTEXT
+
+/* tick配置 */
+#if defined(FLEXILOG_USE_NUMERIC_TIME) || defined(FLEXILOG_USE_OUTPUT_BATCH)
+#define FLEXILOG_TICKS_PER_SECOND 1000       /* flog_port_get_ticks()每秒的tick数 @note 例如毫秒tick为1000, 纳秒为1000000000 */
+#endif
+
+/* 数值时间配置 */
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+#define FLEXILOG_TIME_FRACTION_DIGITS 3      /* 秒以下的位数 @note 0~9, 0表示不输出秒以下部分 */
+#define FLEXILOG_TIME_TEXT_LENGTH 32         /* 时间文本缓冲区大小 */
+#if (FLEXILOG_TIME_FRACTION_DIGITS < 0) || (FLEXILOG_TIME_FRACTION_DIGITS > 9)
+#error "FLEXILOG_TIME_FRACTION_DIGITS must be between 0 and 9"
+#endif
+#if (FLEXILOG_TIME_TEXT_LENGTH <= FLEXILOG_TIME_FRACTION_DIGITS + 2)
+#error "FLEXILOG_TIME_TEXT_LENGTH is too small for FLEXILOG_TIME_FRACTION_DIGITS"
+#endif
+#endif // FLEXILOG_USE_NUMERIC_TIME
+
+/* 输出器配置 */
+#ifdef FLEXILOG_USE_SINK
+#define FLEXILOG_SINK_NUM 4                  /* 输出器数量 @note 包括0号输出器, 每个输出器为每个等级保存一份编译后的前缀 */
+#if (FLEXILOG_SINK_NUM < 1) || (FLEXILOG_SINK_NUM > 32)
+#error "FLEXILOG_SINK_NUM must be between 1 and 32"
+#endif
+#endif // FLEXILOG_USE_SINK
+
+/* 合并输出配置 */
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+#define FLEXILOG_BATCH_BUFFER_SIZE (2 * 1024)        /* 暂存缓冲区大小 @note 放不下的日志先输出已暂存的部分, 超过该长度的单条日志直接输出 */
+#define FLEXILOG_BATCH_THRESHOLD 1024                /* 暂存达到该长度时输出 */
+#define FLEXILOG_BATCH_DEADLINE_MS 20                /* 最早暂存的日志等待超过该时间时输出 @note 写入日志和flog_batch_poll()时检查, 0表示不按时间输出 */
+#define FLEXILOG_BATCH_FLUSH_LEVEL FLOG_LEVEL_ERROR  /* 不低于该等级的日志立即输出 */
+//#define FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER            /* 是否使用双缓冲异步输出 @note 由flog_port_output_async()启动输出后立即返回, 完成时调用flog_output_complete(), 输出一块缓冲区时填充另一块 */
+#if (FLEXILOG_BATCH_THRESHOLD < 1) || (FLEXILOG_BATCH_THRESHOLD > FLEXILOG_BATCH_BUFFER_SIZE)
+#error "FLEXILOG_BATCH_THRESHOLD must be between 1 and FLEXILOG_BATCH_BUFFER_SIZE"
+#endif
+#define FLOG_ASSERT_FLUSH() flog_flush()     /* 断言停机前输出暂存的日志 */
+#else
+#define FLOG_ASSERT_FLUSH()
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+
+#if defined(FLEXILOG_USE_OUTPUT_BATCH) && defined(FLEXILOG_USE_ASYNC_OUTPUT)
+#error "FLEXILOG_USE_ASYNC_OUTPUT already merges output in flog_async_process(), enlarge FLEXILOG_ASYNC_BATCH_SIZE instead of defining FLEXILOG_USE_OUTPUT_BATCH"
+#endif
+
+/* 异步输出配置 */
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+#define FLEXILOG_ASYNC_QUEUE_SIZE (4 * 1024)                    /* 异步队列大小 @note 不能小于FLEXILOG_LINE_MAX_LENGTH */
+#define FLEXILOG_ASYNC_BATCH_SIZE 256                           /* 后台任务单次输出的最大长度 */
+#define FLEXILOG_ASYNC_OVERFLOW_POLICY FLOG_ASYNC_DROP_OLDEST   /* 队列满时的默认处理策略 @ref FLOG_ASYNC_POLICY @note FLOG_ASYNC_BLOCK需要FLEXILOG_USE_THREAD_CONTEXT, 否则使用FLOG_ASYNC_DROP_OLDEST */
+#if (FLEXILOG_ASYNC_QUEUE_SIZE < FLEXILOG_LINE_MAX_LENGTH)
+#error "FLEXILOG_ASYNC_QUEUE_SIZE must not be less than FLEXILOG_LINE_MAX_LENGTH"
+#endif
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
 
 /* 多种环形缓冲区定义 */
 #ifdef FLEXILOG_USE_RING_BUFFER
@@ -45,19 +125,61 @@
 #define FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER     /* 使用输出环形缓冲区    @note 会记录所有向硬件输出的日志 */
 #define FLEXILOG_USE_RECOD_LOG_RING_BUFFER      /* 使用记录环形缓冲区    @note 会记录特定等级以上的日志，默认为FLOG_LEVEL_RECORD */
 #define FLEXILOG_USE_EVENT_LOG_RING_BUFFER      /* 使用事件环形缓冲区    @note 会记录相关事件触发的日志 */
+//#define FLEXILOG_USE_LOCK_FREE_RING_BUFFER      /* 使用无锁环形缓冲区    @note 多线程可同时写入, 需要C11原子操作, 缓冲区大小向下取整为2的幂, 不能在中断中写日志 */
+//#define FLEXILOG_USE_FRAMED_RING_BUFFER         /* 使用记录格式环形缓冲区 @note 每条日志带记录头(长度,等级,序号), 读取按记录跳转, 覆盖时丢弃整条记录 */
+//#define FLEXILOG_USE_SHARED_RING_BUFFER         /* 使用共享存储         @note 每条日志只写入全部环形缓冲区一次, 输出/记录/事件缓冲区变为按掩码过滤的读取视图, 需要FLEXILOG_USE_FRAMED_RING_BUFFER */
+//#define FLEXILOG_USE_DEFERRED_FORMAT            /* 使用延迟格式化       @note 关闭硬件输出时只保存时间戳和参数, 读取时再格式化, 格式字符串和tag必须是常量, 需要FLEXILOG_USE_FRAMED_RING_BUFFER */
+//#define FLEXILOG_USE_BINARY_HEX_DUMP           /* 十六进制输出保存为二进制记录 @note 环形缓冲区只保存原始数据和标题, 读取时再渲染为表格, 关闭硬件输出时不渲染文本, 需要FLEXILOG_USE_FRAMED_RING_BUFFER */
+//#define FLEXILOG_USE_ZERO_COPY_RING_BUFFER      /* 直接格式化到全部环形缓冲区 @note 预留空间连续时省去行缓冲区的拷贝, 记录格式下提交时按实际长度丢弃最旧的记录, 一行覆盖超过32条旧记录时改用行缓冲区, 不能与线程独立缓冲区和无锁环形缓冲区同时使用 */
+#endif // FLEXILOG_USE_RING_BUFFER
+
+/* 环形缓冲区实现配置 */
+//#define FLEXILOG_USE_POW2_RING_BUFFER           /* 使用2的幂环形缓冲区   @note 缓冲区大小向下取整为2的幂, 读写指针自由增长并用掩码取下标 */
+
+#if defined(FLEXILOG_USE_LOCK_FREE_RING_BUFFER) && defined(FLEXILOG_USE_FRAMED_RING_BUFFER)
+#error "FLEXILOG_USE_LOCK_FREE_RING_BUFFER already stores framed records, do not define FLEXILOG_USE_FRAMED_RING_BUFFER"
+#endif
+
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) && (!defined(FLEXILOG_USE_FRAMED_RING_BUFFER) || !defined(FLEXILOG_USE_ALL_LOG_RING_BUFFER))
+#error "FLEXILOG_USE_DEFERRED_FORMAT requires FLEXILOG_USE_FRAMED_RING_BUFFER and FLEXILOG_USE_ALL_LOG_RING_BUFFER"
+#endif
+
+#if defined(FLEXILOG_USE_BINARY_HEX_DUMP) && !defined(FLEXILOG_USE_FRAMED_RING_BUFFER)
+#error "FLEXILOG_USE_BINARY_HEX_DUMP requires FLEXILOG_USE_FRAMED_RING_BUFFER"
+#endif
+
+#if defined(FLEXILOG_USE_SHARED_RING_BUFFER) && (!defined(FLEXILOG_USE_FRAMED_RING_BUFFER) || !defined(FLEXILOG_USE_ALL_LOG_RING_BUFFER))
+#error "FLEXILOG_USE_SHARED_RING_BUFFER requires FLEXILOG_USE_FRAMED_RING_BUFFER and FLEXILOG_USE_ALL_LOG_RING_BUFFER"
+#endif
+
+#if defined(FLEXILOG_USE_ZERO_COPY_RING_BUFFER) && !defined(FLEXILOG_USE_ALL_LOG_RING_BUFFER)
+#error "FLEXILOG_USE_ZERO_COPY_RING_BUFFER requires FLEXILOG_USE_ALL_LOG_RING_BUFFER"
+#endif
+
+#if defined(FLEXILOG_USE_ZERO_COPY_RING_BUFFER) && (defined(FLEXILOG_USE_THREAD_CONTEXT) || defined(FLEXILOG_USE_LOCK_FREE_RING_BUFFER))
+#error "FLEXILOG_USE_ZERO_COPY_RING_BUFFER formats inside the log lock, do not define FLEXILOG_USE_THREAD_CONTEXT or FLEXILOG_USE_LOCK_FREE_RING_BUFFER"
+#endif
+
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+#define FLEXILOG_CACHE_LINE_SIZE 64             /* 缓存行大小, 无锁环形缓冲区的读写指针分别独占一个缓存行 */
+#define FLEXILOG_LFRB_YIELD_LIMIT 16            /* 最旧记录未提交时最多让出CPU的次数, 超过后丢弃新日志 */
+#endif
+
+#ifdef FLEXILOG_USE_RING_BUFFER
 
 /* 启用自动分配内存后会在flog_init函数中分配内存 */
+/* 使用共享存储时只需要全部环形缓冲区, 其他缓冲区是它的读取视图 */
 #ifdef FLEXILOG_AUTO_MALLOC
 #ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
 #define FLEXILOG_ALL_RING_BUFFER_SIZE (5 * 1024)    /* 全部环形缓冲区 的大小 */
 #endif
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+#if defined(FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
 #define FLEXILOG_OUTPUT_RING_BUFFER_SIZE (2 * 1024) /* 输出环形缓冲区 的大小 */
 #endif
-#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+#if defined(FLEXILOG_USE_RECOD_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
 #define FLEXILOG_RECOD_RING_BUFFER_SIZE (1 * 1024) /* 记录环形缓冲区 的大小 */
 #endif
-#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+#if defined(FLEXILOG_USE_EVENT_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
 #define FLEXILOG_EVENT_RING_BUFFER_SIZE (1 * 1024) /* 事件环形缓冲区 的大小 */
 #endif
 #else
@@ -68,15 +190,15 @@ typedef struct
     uint32_t all_buffer_size;    /* 全部环形缓冲区 的大小 */
     char *all_log_buffer;        /* 存储全部日志的缓冲区 */
 #endif
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+#if defined(FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
     uint32_t output_buffer_size;    /* 输出环形缓冲区 的大小 */
     char *output_log_buffer;        /* 存储输出日志的缓冲区 */
 #endif
-#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+#if defined(FLEXILOG_USE_RECOD_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
     uint32_t recod_buffer_size;    /* 记录环形缓冲区 的大小 */
     char *recod_log_buffer;       /* 存储记录日志的缓冲区 */
 #endif
-#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+#if defined(FLEXILOG_USE_EVENT_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
     uint32_t event_buffer_size;    /* 事件环形缓冲区 的大小 */
     char *event_log_buffer;        /* 存储事件日志的缓冲区 */
 #endif
@@ -129,6 +251,18 @@ typedef enum
     FLOG_FMT_ALL        = 0x1FFF     /* 所有格式 */
 }FLOG_FMT;
 
+#ifdef FLEXILOG_USE_SINK
+/**
+ * @brief 输出器
+ * @note  输出函数与flog_port_output()相同, 在日志锁内调用
+ * @note  tag掩码的第n位对应flog_register_tag()返回的编号n, 编号31及以上和未注册的tag共用第31位
+ */
+typedef void (*flog_sink_output_t)(const char *buf, size_t size);
+#define FLOG_SINK_PORT      0                   /* flog_port_output()对应的输出器 */
+#define FLOG_SINK_TAG_ALL   0xFFFFFFFFU         /* 输出所有tag */
+#define FLOG_SINK_TAG(id)   (1U << (((id) >= 0 && (id) < 31) ? (id) : 31))  /* tag编号对应的掩码 */
+#endif // FLEXILOG_USE_SINK
+
 /**
  * @brief 字体颜色
  */
@@ -163,6 +297,58 @@ typedef enum
     FLOG_DATA_TYPE_WORD,            /* 单字  uint32_t */
 }FLOG_DATA_TYPE;
 
+/**
+ * @brief 格式化上下文
+ * @note  未启用FLEXILOG_USE_THREAD_CONTEXT时全局共用一个, 格式化在锁内进行
+ * @note  启用后每个线程一个, 由线程局部存储或flog_port_get_context()提供
+ */
+typedef struct
+{
+    char line_buffer[FLEXILOG_LINE_MAX_LENGTH];  /* 格式化缓冲区 */
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+    uint64_t time_second;                        /* 时间缓存对应的秒 */
+    uint32_t time_second_len;                    /* 时间缓存中秒以上部分的长度, 0表示缓存无效 */
+    char time_text[FLEXILOG_TIME_TEXT_LENGTH];   /* 时间缓存 */
+#endif // FLEXILOG_USE_NUMERIC_TIME
+#ifdef FLEXILOG_USE_THREAD_NAME_CACHE
+    uint32_t thread_name_len;                    /* 线程名长度, 0表示未缓存 */
+    char thread_name[FLEXILOG_THREAD_NAME_MAX_LENGTH + 1];  /* 线程名缓存 */
+#endif // FLEXILOG_USE_THREAD_NAME_CACHE
+#ifdef FLEXILOG_USE_SINK
+    char sink_buffer[FLEXILOG_LINE_MAX_LENGTH];  /* 输出器使用独立格式时的渲染缓冲区 */
+#endif // FLEXILOG_USE_SINK
+}flog_context_t;
+
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+/**
+ * @brief 合并输出统计
+ * @note  平均每次输出的日志条数为line_count / write_count, 平均长度为byte_count / write_count
+ */
+typedef struct
+{
+    uint32_t line_count;        /* 写入的日志条数 */
+    uint32_t write_count;       /* 调用flog_port_output()或flog_port_output_async()的次数 */
+    uint32_t byte_count;        /* 输出的字节数 */
+    uint32_t full_count;        /* 达到阈值或放不下时输出的次数 */
+    uint32_t deadline_count;    /* 超过期限时输出的次数 */
+    uint32_t level_count;       /* 遇到高等级日志时输出的次数 */
+    uint32_t flush_count;       /* 调用flog_flush()时输出的次数 */
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    uint32_t wait_count;        /* 等待输出完成的次数 @note 两块缓冲区都不可用, 超长日志或flog_flush()时等待 */
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+}flog_batch_stats_t;
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+
+/**
+ * @brief 异步队列溢出策略
+ */
+typedef enum
+{
+    FLOG_ASYNC_BLOCK = 0,       /* 阻塞等待后台任务腾出空间 */
+    FLOG_ASYNC_DROP_NEWEST,     /* 丢弃新写入的日志 */
+    FLOG_ASYNC_DROP_OLDEST,     /* 丢弃队列中最旧的日志 */
+}FLOG_ASYNC_POLICY;
+
 
 #if defined(FLEXILOG_USE_RING_BUFFER) && !defined(FLEXILOG_AUTO_MALLOC)
 void flog_init(FLOG_RingBuffer_Init_Paremeter *parameter);
@@ -170,23 +356,51 @@ void flog_init(FLOG_RingBuffer_Init_Paremeter *parameter);
 void flog_init(void);
 #endif
 
-void flog_enable_fmt(FLOG_LEVEL level, uint16_t fmt);
-void flog_disable_fmt(FLOG_LEVEL level, uint16_t fmt);
-void flog_set_level_fmt(FLOG_LEVEL level, uint16_t fmt);
-void flog_set_font_color(FLOG_LEVEL level, FLOG_COLOR color);
-void flog_set_bg_color(FLOG_LEVEL level, FLOG_COLOR color);
+bool flog_enable_fmt(FLOG_LEVEL level, uint16_t fmt);
+bool flog_disable_fmt(FLOG_LEVEL level, uint16_t fmt);
+bool flog_set_level_fmt(FLOG_LEVEL level, uint16_t fmt);
+bool flog_set_level_pattern(FLOG_LEVEL level, const char *pattern);
+bool flog_set_font_color(FLOG_LEVEL level, FLOG_COLOR color);
+bool flog_set_bg_color(FLOG_LEVEL level, FLOG_COLOR color);
 
 void flog_hardware_output_enable(bool enable);
 void flog_lock_enable(bool enable);
+#ifdef FLEXILOG_USE_THREAD_NAME_CACHE
+void flog_set_thread_name(const char *name);
+#endif // FLEXILOG_USE_THREAD_NAME_CACHE
+#ifdef FLEXILOG_USE_SINK
+int flog_sink_register(flog_sink_output_t output, FLOG_LEVEL level);
+void flog_sink_unregister(int sink);
+void flog_sink_enable(int sink, bool enable);
+void flog_sink_set_level(int sink, FLOG_LEVEL level);
+void flog_sink_set_tag_mask(int sink, uint32_t mask);
+void flog_sink_set_fmt(int sink, uint16_t fmt);
+bool flog_sink_set_pattern(int sink, const char *pattern);
+#endif // FLEXILOG_USE_SINK
 
 void flog_set_global_filter(FLOG_LEVEL level);
 #if (FLEXILOG_TAG_FILTER_NUM > 0)
-void flog_set_tag_filter(const char *tag, FLOG_LEVEL level);
+int flog_register_tag(const char *tag);
+bool flog_set_tag_filter(const char *tag, FLOG_LEVEL level);
+bool flog_clear_tag_filter(const char *tag);
 #endif
 
 void flog_printf(bool write_ring_buffer, const char *fmt, ...);
 void flog_output(FLOG_LEVEL level, const char *tag, const char *file, const char *func, uint32_t line, const char *fmt, ...);
 void flog_hex_dump(char *tag, void *title, uint32_t size, FLOG_DATA_TYPE type);
+void flog_flush(void);
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+uint32_t flog_async_process(void);
+bool flog_async_set_policy(FLOG_ASYNC_POLICY policy);
+uint32_t flog_async_get_drop_count(void);
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+void flog_batch_poll(void);
+void flog_batch_get_stats(flog_batch_stats_t *stats);
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+void flog_output_complete(void);
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+#endif // FLEXILOG_USE_OUTPUT_BATCH
 #ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
 void flog_output_event(FLOG_EVENT event, const char *file, const char *func, uint32_t line, const char *fmt, ...);
 #endif
@@ -208,14 +422,85 @@ uint32_t flog_read_record(char *data, uint32_t size);
 uint32_t flog_read_event(FLOG_EVENT event, char *data, uint32_t size);
 #endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
 
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+uint32_t flog_ring_buffer_get_drop_count(void);
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+
+/**
+ * @brief 日志宏的快速过滤
+ * @note  flog_level_mask为所有tag能输出等级的并集, 被过滤的日志只需一次读取和一次跳转, 不求值参数
+ * @note  启用tag过滤时每个调用处缓存本tag的等级掩码, 过滤配置改变后重新计算, 因此FLOG_TAG在同一调用处必须不变
+ */
+extern volatile uint8_t flog_level_mask;
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+extern volatile uint32_t flog_filter_generation;
+uint32_t flog_update_tag_cache(const char *tag, uint32_t *cache);
+#endif
+
+static inline bool flog_level_enabled(FLOG_LEVEL level, const char *tag, uint32_t *cache)
+{
+    if ((flog_level_mask & (1U << level)) == 0)
+        return false;
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+    uint32_t tag_cache = *cache;
+    if ((tag_cache >> 8) != flog_filter_generation)
+        tag_cache = flog_update_tag_cache(tag, cache);
+    return (tag_cache & (1U << level)) != 0;
+#else
+    (void)tag;
+    (void)cache;
+    return true;
+#endif
+}
+
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+#define flog_output_checked(level, tag, ...) do { static uint32_t flog_tag_cache = 0; if (flog_level_enabled(level, tag, &flog_tag_cache)) flog_output(level, tag, __VA_ARGS__); } while (0)
+#else
+#define flog_output_checked(level, tag, ...) do { if (flog_level_enabled(level, tag, NULL)) flog_output(level, tag, __VA_ARGS__); } while (0)
+#endif
+
 /* 日志接口输出 */
 #define log_printf(...) flog_printf(true, __VA_ARGS__); /* 全功能printf 函数, 不受任何配置影响 */
-#define logd(...) flog_output(FLOG_LEVEL_DEBUG, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)  /* 调试日志 */
-#define logi(...) flog_output(FLOG_LEVEL_INFO, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)   /* 提示日志 */
-#define logw(...) flog_output(FLOG_LEVEL_WARN, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)   /* 警告日志 */
-#define loge(...) flog_output(FLOG_LEVEL_ERROR, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)  /* 错误日志 */
-#define logr(...) flog_output(FLOG_LEVEL_RECORD, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__) /* 记录日志 */
-#define loga(...) flog_output(FLOG_LEVEL_ASSERT, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__) /* 断言日志 */
+/* 每个文件可以在包含本头文件之前, 和FLOG_TAG一起定义FLOG_COMPILE_LEVEL来覆盖FLEXILOG_COMPILE_LEVEL */
+#ifdef FLOG_COMPILE_LEVEL
+#define FLOG_LOCAL_COMPILE_LEVEL FLOG_COMPILE_LEVEL
+#else
+#define FLOG_LOCAL_COMPILE_LEVEL FLEXILOG_COMPILE_LEVEL
+#endif
+
+/* 被移除的日志仍做参数类型检查, 但不会生成代码和字符串 */
+#define flog_output_stripped(...) do { if (0) flog_output(__VA_ARGS__); } while (0)
+
+#if (FLOG_LOCAL_COMPILE_LEVEL <= 0)
+#define logd(...) flog_output_checked(FLOG_LEVEL_DEBUG, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)  /* 调试日志 */
+#else
+#define logd(...) flog_output_stripped(FLOG_LEVEL_DEBUG, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)
+#endif
+#if (FLOG_LOCAL_COMPILE_LEVEL <= 1)
+#define logi(...) flog_output_checked(FLOG_LEVEL_INFO, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)   /* 提示日志 */
+#else
+#define logi(...) flog_output_stripped(FLOG_LEVEL_INFO, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)
+#endif
+#if (FLOG_LOCAL_COMPILE_LEVEL <= 2)
+#define logw(...) flog_output_checked(FLOG_LEVEL_WARN, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)   /* 警告日志 */
+#else
+#define logw(...) flog_output_stripped(FLOG_LEVEL_WARN, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)
+#endif
+#if (FLOG_LOCAL_COMPILE_LEVEL <= 3)
+#define loge(...) flog_output_checked(FLOG_LEVEL_ERROR, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)  /* 错误日志 */
+#else
+#define loge(...) flog_output_stripped(FLOG_LEVEL_ERROR, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)
+#endif
+#if (FLOG_LOCAL_COMPILE_LEVEL <= 4)
+#define logr(...) flog_output_checked(FLOG_LEVEL_RECORD, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__) /* 记录日志 */
+#else
+#define logr(...) flog_output_stripped(FLOG_LEVEL_RECORD, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)
+#endif
+#if (FLOG_LOCAL_COMPILE_LEVEL <= 5)
+#define loga(...) flog_output_checked(FLOG_LEVEL_ASSERT, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__) /* 断言日志 */
+#else
+#define loga(...) flog_output_stripped(FLOG_LEVEL_ASSERT, FLOG_TAG, __FILE_NAME__, __FUNCTION__,  __LINE__, __VA_ARGS__)
+#endif
 #ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
 #define log_event(event, ...) flog_output_event(event, __FILE_NAME__, __FUNCTION__, __LINE__, __VA_ARGS__)      /* 事件日志 */
 #endif
@@ -0,0 +1,26 @@
+/**
+ * ==================================================
+ *  @file flexi_log_defer.h
+ *  @brief flexi log 延迟格式化
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-18 下午9:05
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#ifndef FLEXILOG_FLEXI_LOG_DEFER_H
+#define FLEXILOG_FLEXI_LOG_DEFER_H
+
+#include "flexi_log.h"
+#ifdef FLEXILOG_USE_DEFERRED_FORMAT
+#include "stdint.h"
+#include "stdbool.h"
+#include "stdarg.h"
+
+bool flog_defer_pack(char *buffer, uint32_t size, const char *fmt, va_list args, uint32_t *pack_size);
+uint32_t flog_defer_pack_string(char *buffer, uint32_t size, const char *str);
+uint32_t flog_defer_render(char *text, uint32_t size, const char *fmt, const char *args, uint32_t args_size);
+#endif // FLEXILOG_USE_DEFERRED_FORMAT
+#endif //FLEXILOG_FLEXI_LOG_DEFER_H
@@ -0,0 +1,48 @@
+/**
+ * ==================================================
+ *  @file flexi_log_filter.h
+ *  @brief flexi log tag过滤规则
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-20 下午8:30
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#ifndef FLEXILOG_FLEXI_LOG_FILTER_H
+#define FLEXILOG_FLEXI_LOG_FILTER_H
+
+#include "flexi_log.h"
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+#include "stdint.h"
+#include "stdbool.h"
+
+#define FLOG_FILTER_LEVEL_NONE  0xFF    /* 未设置等级 */
+#define FLOG_FILTER_NODE_NONE   0       /* 空节点, 0号节点为根节点, 不会作为子节点 */
+#define FLOG_FILTER_SEPARATOR   '.'     /* tag层级分隔符 */
+#define FLOG_FILTER_WILDCARD    "*"     /* 通配符, 只能作为最后一级 */
+
+/* 规则树节点, 每个节点对应tag的一级 */
+typedef struct
+{
+    char name[FLEXILOG_TAG_MAX_LENGTH + 1]; /* 本级名称 */
+    uint8_t level;                          /* "a.b"规则的等级, 作用于a.b及其下级 */
+    uint8_t wildcard_level;                 /* "a.b.*"规则的等级, 只作用于a.b的下级 */
+    uint16_t child;                         /* 第一个子节点 */
+    uint16_t sibling;                       /* 下一个兄弟节点 */
+}flog_filter_node_t;
+
+/* 规则树 */
+typedef struct
+{
+    flog_filter_node_t nodes[FLEXILOG_TAG_RULE_NODE_NUM];
+    uint16_t node_num;                      /* 使用过的节点数量 */
+    uint16_t free_node;                     /* 回收的节点链表, 通过sibling连接 */
+}flog_filter_t;
+
+void flog_filter_init(flog_filter_t *filter);
+bool flog_filter_set(flog_filter_t *filter, const char *pattern, uint8_t level);
+uint8_t flog_filter_resolve(const flog_filter_t *filter, const char *tag);
+#endif // FLEXILOG_TAG_FILTER_NUM > 0
+#endif //FLEXILOG_FLEXI_LOG_FILTER_H
@@ -0,0 +1,33 @@
+/**
+ * ==================================================
+ *  @file flexi_log_format.h
+ *  @brief flexi log 内置格式化
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-23 下午7:40
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#ifndef FLEXILOG_FLEXI_LOG_FORMAT_H
+#define FLEXILOG_FLEXI_LOG_FORMAT_H
+
+#include "flexi_log.h"
+#include "stdarg.h"
+
+#ifdef FLEXILOG_USE_BUILTIN_FORMAT
+#include "stdint.h"
+
+int flog_vformat(char *buffer, uint32_t size, const char *fmt, va_list args);
+int flog_format(char *buffer, uint32_t size, const char *fmt, ...);
+
+#define flog_vsnprintf(buffer, size, fmt, args) flog_vformat(buffer, size, fmt, args)
+#define flog_snprintf(buffer, size, ...)        flog_format(buffer, size, __VA_ARGS__)
+#else
+#include "stdio.h"
+
+#define flog_vsnprintf(buffer, size, fmt, args) vsnprintf(buffer, size, fmt, args)
+#define flog_snprintf(buffer, size, ...)        snprintf(buffer, size, __VA_ARGS__)
+#endif // FLEXILOG_USE_BUILTIN_FORMAT
+#endif //FLEXILOG_FLEXI_LOG_FORMAT_H
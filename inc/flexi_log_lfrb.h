@@ -0,0 +1,41 @@
+/**
+ * ==================================================
+ *  @file flexi_log_lfrb.h
+ *  @brief flexi log 无锁多生产者环形缓冲区
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-16 下午8:30
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#ifndef FLEXILOG_FLEXI_LOG_LFRB_H
+#define FLEXILOG_FLEXI_LOG_LFRB_H
+
+#include "flexi_log.h"
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+#include "stdint.h"
+#include "stdatomic.h"
+#include "stdbool.h"
+
+/* 无锁环形缓冲区 */
+typedef struct
+{
+    char *buffer;
+    uint32_t size;      /* 缓冲区大小, 2的幂 */
+    uint32_t mask;      /* 下标掩码 */
+    _Alignas(FLEXILOG_CACHE_LINE_SIZE) _Atomic uint32_t write_pos;  /* 写入预留位置, 自由增长 */
+    _Alignas(FLEXILOG_CACHE_LINE_SIZE) _Atomic uint32_t read_pos;   /* 最旧记录位置, 自由增长 */
+    _Atomic uint32_t drop_count;    /* 等待超时丢弃的日志数量 */
+}flog_lfrb_t;
+
+void flog_lfrb_init(flog_lfrb_t *rb, char *buffer, uint32_t size);
+#ifdef FLEXILOG_AUTO_MALLOC
+void flog_lfrb_buffer_create(flog_lfrb_t *rb, uint32_t size);
+#endif //FLEXILOG_AUTO_MALLOC
+uint32_t flog_lfrb_read_lines(flog_lfrb_t *rb, char *data, uint32_t size);
+bool flog_lfrb_write_force(flog_lfrb_t *rb, const char *data, uint32_t size);
+uint32_t flog_lfrb_get_drop_count(flog_lfrb_t *rb);
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+#endif //FLEXILOG_FLEXI_LOG_LFRB_H
@@ -14,7 +14,7 @@
 #define FLEXILOG_FLEXI_LOG_RB_H
 
 #include "flexi_log.h"
-#ifdef FLEXILOG_USE_RING_BUFFER
+#if defined(FLEXILOG_USE_RING_BUFFER) || defined(FLEXILOG_USE_ASYNC_OUTPUT)
 #include "stdint.h"
 
 /* 环形缓冲区 */
@@ -22,17 +22,89 @@ typedef struct
 {
     char *buffer;
     uint32_t size;
+#ifdef FLEXILOG_USE_POW2_RING_BUFFER
+    /* 读写都在日志锁内进行, 读写指针不需要分开缓存行 */
+    uint32_t mask;      /* 下标掩码 */
+    uint32_t write_pos; /* 写入位置, 自由增长 */
+    uint32_t read_pos;  /* 读取位置, 自由增长 */
+#else
     uint32_t read_pos : 31;
     uint32_t read_pos_mirror : 1;
     uint32_t write_pos : 31;
     uint32_t write_pos_mirror : 1;
+#endif // FLEXILOG_USE_POW2_RING_BUFFER
 }flog_ring_buffer_t;
 
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+/* 预留的写入空间, 跨越缓冲区末尾时分为两段 */
+typedef struct
+{
+    char *data;
+    uint32_t size;
+}flog_rb_span_t;
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+
+#ifdef FLEXILOG_USE_FRAMED_RING_BUFFER
+/* 记录头 */
+typedef struct
+{
+    uint16_t length;    /* 数据长度 */
+    uint8_t level;      /* 日志等级 */
+    uint8_t target;     /* 日志所属的视图掩码 */
+    uint32_t sequence;  /* 日志序号 */
+}flog_rb_record_t;
+
+#define FLOG_RB_RECORD_BINARY   0x80        /* 记录头target标志: 记录内容为二进制, 读取时需要渲染为文本 */
+#define FLOG_RB_NO_SPACE        UINT32_MAX  /* 数据缓冲区剩余空间不足 */
+
+/**
+ * @brief 二进制记录渲染函数
+ * @param head 记录头
+ * @param record 记录内容
+ * @param text 文本缓冲区
+ * @param size 文本缓冲区大小
+ * @return 完整文本的长度, 不小于size时表示空间不足
+ */
+typedef uint32_t (*flog_rb_render_t)(const flog_rb_record_t *head, const char *record, char *text, uint32_t size);
+#endif // FLEXILOG_USE_FRAMED_RING_BUFFER
+
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+#define FLOG_RB_VIEW_ANY_LEVEL 0xFF     /* 视图不过滤等级 */
+
+/* 共享存储的读取视图 */
+typedef struct
+{
+    uint8_t target;     /* 视图掩码 */
+    uint8_t level;      /* 等级过滤 */
+    uint32_t sequence;  /* 下一条要读取的日志序号 */
+}flog_rb_view_t;
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+
 void flog_rb_init(flog_ring_buffer_t *rb, char *buffer, uint32_t size);
 #ifdef FLEXILOG_AUTO_MALLOC
 void flog_rb_buffer_create(flog_ring_buffer_t *rb, uint32_t size);
 #endif //FLEXILOG_AUTO_MALLOC
+uint32_t flog_rb_get_used(flog_ring_buffer_t *rb);
+uint32_t flog_rb_get_free(flog_ring_buffer_t *rb);
+uint32_t flog_rb_read(flog_ring_buffer_t *rb, char *data, uint32_t size);
 uint32_t flog_rb_read_lines(flog_ring_buffer_t *rb, char *data, uint32_t size);
+void flog_rb_drop_lines(flog_ring_buffer_t *rb, uint32_t size);
 void flog_rb_write_force(flog_ring_buffer_t *rb, const char *data, uint32_t size);
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+uint32_t flog_rb_reserve(flog_ring_buffer_t *rb, uint32_t size, flog_rb_span_t span[2]);
+void flog_rb_commit(flog_ring_buffer_t *rb, uint32_t size);
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+#ifdef FLEXILOG_USE_FRAMED_RING_BUFFER
+void flog_rb_write_record(flog_ring_buffer_t *rb, const char *data, uint32_t size, uint8_t level, uint8_t target, uint32_t sequence);
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+uint32_t flog_rb_reserve_record(flog_ring_buffer_t *rb, uint32_t size, flog_rb_span_t span[2]);
+void flog_rb_commit_record(flog_ring_buffer_t *rb, uint32_t size, uint8_t level, uint8_t target, uint32_t sequence);
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+uint32_t flog_rb_read_records(flog_ring_buffer_t *rb, char *data, uint32_t size, flog_rb_render_t render);
+#endif // FLEXILOG_USE_FRAMED_RING_BUFFER
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+void flog_rb_view_init(flog_rb_view_t *view, uint8_t target, uint8_t level);
+uint32_t flog_rb_read_view(flog_ring_buffer_t *rb, flog_rb_view_t *view, char *data, uint32_t size, flog_rb_render_t render);
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
 #endif
 #endif //FLEXILOG_FLEXI_LOG_RB_H
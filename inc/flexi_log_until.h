@@ -19,5 +19,10 @@
 uint32_t flog_strcat(char *dest, const char *src, uint32_t max_size);
 uint32_t flog_strlen(const char *str);
 bool flog_strcmp(const char *str1, const char *str2);
+uint32_t flog_strhash(const char *str, uint32_t max_len);
+uint32_t flog_utoa(char *dest, uint32_t value);
+uint32_t flog_itoa(char *dest, int32_t value);
+void flog_hex8(char *dest, uint8_t value);
+void flog_hex32(char *dest, uint32_t value);
 
 #endif //FLEXILOG_FLEXI_LOG_UNTIL_H
@@ -48,6 +48,36 @@ void flog_port_unlock(void)
     /* TODO: 添加解锁代码 */
 }
 
+#if defined(FLEXILOG_USE_NUMERIC_TIME) || defined(FLEXILOG_USE_OUTPUT_BATCH)
+/**
+ * @brief 获取tick
+ * @note  频率为FLEXILOG_TICKS_PER_SECOND, 例如系统毫秒tick或纳秒时钟, 合并输出用它判断暂存日志的期限
+ */
+uint64_t flog_port_get_ticks(void)
+{
+    /* TODO: 添加tick代码 */
+    return 0;
+}
+#endif
+
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+/**
+ * @brief 格式化秒以上的时间
+ * @note  结果按秒缓存, 同一秒内不会重复调用, 秒以下的部分由内核追加
+ * @param second 秒, 即tick / FLEXILOG_TICKS_PER_SECOND
+ * @param buf 输出缓冲区
+ * @param size 输出缓冲区大小
+ */
+void flog_port_format_seconds(uint64_t second, char *buf, uint32_t size)
+{
+    /* TODO: 添加时间转换代码, 例如localtime_r + strftime */
+    (void)second;
+    if (size > 0)
+    {
+        buf[0] = '\0';
+    }
+}
+#else
 /**
  * @brief 获取时间
  */
@@ -56,9 +86,11 @@ const char *flog_port_get_time(void)
     /* TODO: 添加时间代码 */
     return "";
 }
+#endif
 
 /**
  * @brief 获取线程ID
+ * @note  启用FLEXILOG_USE_THREAD_NAME_CACHE时每个线程只在第一次输出时调用
  */
 const char *flog_port_get_thread(void)
 {
@@ -66,6 +98,59 @@ const char *flog_port_get_thread(void)
     return "";
 }
 
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) && !defined(FLEXILOG_USE_NUMERIC_TIME)
+/**
+ * @brief 获取时间戳
+ * @note  延迟格式化时保存到日志记录中, 例如系统tick
+ */
+uint32_t flog_port_get_timestamp(void)
+{
+    /* TODO: 添加时间戳代码 */
+    return 0;
+}
+
+/**
+ * @brief 时间戳转换为时间字符串
+ * @note  延迟格式化读取日志时调用, 输出格式应与flog_port_get_time()一致
+ * @param timestamp 时间戳
+ * @param buf 输出缓冲区
+ * @param size 输出缓冲区大小
+ */
+void flog_port_format_timestamp(uint32_t timestamp, char *buf, uint32_t size)
+{
+    /* TODO: 添加时间转换代码 */
+    (void)timestamp;
+    if (size > 0)
+    {
+        buf[0] = '\0';
+    }
+}
+#endif
+
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+/**
+ * @brief 让出CPU
+ * @note  无锁环形缓冲区等待其他线程提交日志时调用, 例如 sched_yield() 或 taskYIELD()
+ */
+void flog_port_yield(void)
+{
+    /* TODO: 添加让出CPU代码 */
+}
+#endif
+
+#if defined(FLEXILOG_USE_THREAD_CONTEXT) && !defined(FLEXILOG_THREAD_LOCAL)
+/**
+ * @brief 获取当前线程的格式化上下文
+ * @note  每个线程需要返回各自的上下文, 例如保存在任务的线程局部存储指针中
+ */
+flog_context_t *flog_port_get_context(void)
+{
+    /* TODO: 添加获取线程上下文代码 */
+    static flog_context_t context;
+    return &context;
+}
+#endif
+
 #ifdef FLEXILOG_AUTO_MALLOC
 /**
  * @brief 内存分配
@@ -85,3 +170,48 @@ void flog_port_free(void *ptr)
     free(ptr);
 }
 #endif
+
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+/**
+ * @brief 唤醒后台输出任务
+ * @note  日志写入异步队列后调用, 例如释放信号量, 后台任务被唤醒后调用flog_async_process()
+ */
+void flog_port_async_notify(void)
+{
+    /* TODO: 添加唤醒代码 */
+}
+
+/**
+ * @brief 等待后台输出任务
+ * @note  队列已满(FLOG_ASYNC_BLOCK)或flog_flush()等待时调用, 可以让出CPU或短暂延时
+ */
+void flog_port_async_wait(void)
+{
+    /* TODO: 添加等待代码 */
+}
+#endif
+
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+/**
+ * @brief 启动异步输出
+ * @note  例如配置DMA后立即返回, 输出完成后在中断中调用flog_output_complete(), 在此之前buf保持不变
+ * @note  同一时间只有一次输出, 多核时调用flog_output_complete()前需要保证对buf的读取已经完成
+ * @param buf 输出数据
+ * @param size 输出数据长度
+ */
+void flog_port_output_async(const char *buf, size_t size)
+{
+    /* TODO: 添加启动DMA代码 */
+    flog_port_output(buf, size);
+    flog_output_complete();
+}
+
+/**
+ * @brief 等待异步输出完成
+ * @note  两块缓冲区都不可用或flog_flush()等待时调用, 可以让出CPU或短暂延时
+ */
+void flog_port_output_wait(void)
+{
+    /* TODO: 添加等待代码 */
+}
+#endif
@@ -0,0 +1,128 @@
+/**
+ * ==================================================
+ *  @file flexi_log_format_bench.c
+ *  @brief flexi log 内置格式化与C库snprintf的对比测试
+ *  @note  用法: flexi_log_format_bench [每个场景的次数], 结果打印到标准输出
+ *  @note  只依赖flexi_log_format.c, flexi_log_until.c和标准C库, 不需要移植层和线程,
+ *         用newlib/picolibc工具链编译后即为内置格式化与newlib/picolibc的对比
+ *  @note  默认用clock()计时, 目标板没有clock()时定义BENCH_TICKS()和BENCH_TICKS_PER_SEC, 例如使用DWT周期计数器
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-29 下午7:30
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+#include "flexi_log.h"
+#include "flexi_log_format.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef FLEXILOG_USE_BUILTIN_FORMAT
+#error "flexi_log_format_bench needs FLEXILOG_USE_BUILTIN_FORMAT, define it in inc/flexi_log.h or with -DFLEXILOG_USE_BUILTIN_FORMAT"
+#endif
+
+#ifndef BENCH_TICKS
+#define BENCH_TICKS()           ((double)clock())
+#define BENCH_TICKS_PER_SEC     ((double)CLOCKS_PER_SEC)
+#endif // BENCH_TICKS
+
+#define BENCH_REPEAT 5   /* 单项场景重复次数, 取最好结果 */
+
+static char bench_text[128];
+
+/**
+ * @brief 断言输出
+ * @note  flexlog_assert使用flog_printf, 测试不链接flexi_log.c, 直接输出到标准输出
+ */
+void flog_printf(bool write_ring_buffer, const char *fmt, ...)
+{
+    va_list args;
+    (void)write_ring_buffer;
+    va_start(args, fmt);
+    vprintf(fmt, args);
+    va_end(args);
+}
+
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+void flog_flush(void)
+{
+    fflush(stdout);
+}
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+
+/**
+ * @brief 运行单项场景BENCH_REPEAT次
+ * @param run 场景函数, 参数为执行次数
+ * @param count 每次执行次数
+ * @return 最好结果, 纳秒/次
+ */
+static double bench_best(void (*run)(uint32_t count), uint32_t count)
+{
+    double best = 0;
+    for (int i = 0; i < BENCH_REPEAT; ++i)
+    {
+        double start = BENCH_TICKS();
+        run(count);
+        double elapsed = (BENCH_TICKS() - start) * 1e9 / BENCH_TICKS_PER_SEC / count;
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/* 内置格式化与C库snprintf使用相同的格式和参数, same_##name比较两者的一次输出 */
+#define BENCH_FORMAT_PAIR(name, ...)                                    \
+static void bench_builtin_##name(uint32_t count)                        \
+{                                                                       \
+    for (uint32_t i = 0; i < count; ++i)                                \
+        flog_format(bench_text, sizeof(bench_text), __VA_ARGS__);       \
+}                                                                       \
+static void bench_libc_##name(uint32_t count)                           \
+{                                                                       \
+    for (uint32_t i = 0; i < count; ++i)                                \
+        snprintf(bench_text, sizeof(bench_text), __VA_ARGS__);          \
+}                                                                       \
+static bool bench_same_##name(void)                                     \
+{                                                                       \
+    static char builtin[sizeof(bench_text)];                            \
+    uint32_t i = 12345;                                                 \
+    (void)i;                                                            \
+    flog_format(builtin, sizeof(builtin), __VA_ARGS__);                 \
+    snprintf(bench_text, sizeof(bench_text), __VA_ARGS__);              \
+    return strcmp(builtin, bench_text) == 0;                            \
+}
+
+BENCH_FORMAT_PAIR(int, "id=%d cnt=%u flags=0x%08x", (int)i - 500, i, i * 2654435761u)
+BENCH_FORMAT_PAIR(str, "[%s] read %d bytes from %s", "spi", (int)(i & 0xFFF), (i & 1) ? "flash" : "eeprom")
+BENCH_FORMAT_PAIR(float, "temp=%.2f volt=%f", (double)i * 0.01, (double)i * 0.001)
+BENCH_FORMAT_PAIR(text, "constant text without conversions")
+
+#define BENCH_FORMAT_RUN(name, count)                                                       \
+    printf("format %-6s %10.1f ns builtin %10.1f ns libc   output %s\n", #name,            \
+           bench_best(bench_builtin_##name, count), bench_best(bench_libc_##name, count),   \
+           bench_same_##name() ? "same" : "differs")
+
+int main(int argc, char **argv)
+{
+    uint32_t count = 100000;
+    if (argc > 1 && argv != NULL && argv[1] != NULL)
+    {
+        count = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if (count == 0)
+    {
+        count = 1;
+    }
+    printf("flexi log format bench, %u calls per scenario, best of %d\n", (unsigned)count, BENCH_REPEAT);
+    BENCH_FORMAT_RUN(int, count);
+    BENCH_FORMAT_RUN(str, count);
+    BENCH_FORMAT_RUN(float, count);
+    BENCH_FORMAT_RUN(text, count);
+    return 0;
+}
@@ -0,0 +1,343 @@
+/**
+ * ==================================================
+ *  @file flexi_log_bench.c
+ *  @brief flexi log Linux性能测试
+ *  @note  用法: flexi_log_bench [每个场景的日志条数] [线程数], 日志输出到/dev/null, 结果打印到标准输出
+ *  @note  生产者扩展性按1,2,4..线程数逐级测试, 关闭硬件输出并由一个读取线程同时读取全部环形缓冲区
+ *  @note  单项场景取BENCH_REPEAT次中的最好结果, 对比优化前后需要分别用不同的功能开关编译
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-26 下午8:10
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+#include "flexi_log.h"
+#include "flexi_log_port_linux.h"
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#define FLOG_TAG "bench"
+
+#define BENCH_REPEAT 5   /* 单项场景重复次数, 取最好结果 */
+
+static uint32_t bench_lines = 200000;
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+static volatile int bench_reading = 0;
+#endif
+
+/**
+ * @brief 获取单调时间
+ * @return 纳秒
+ */
+static double bench_now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+/**
+ * @brief 运行单项场景BENCH_REPEAT次
+ * @param run 场景函数, 参数为执行次数
+ * @param count 每次执行次数
+ * @return 最好结果, 纳秒/次
+ */
+static double bench_best(void (*run)(uint32_t count), uint32_t count)
+{
+    double best = 0;
+    for (int i = 0; i < BENCH_REPEAT; ++i)
+    {
+        double start = bench_now();
+        run(count);
+        double elapsed = (bench_now() - start) / count;
+        if (i == 0 || elapsed < best)
+        {
+            best = elapsed;
+        }
+    }
+    return best;
+}
+
+/* 格式化场景: 关闭硬件输出, 启用FLEXILOG_USE_DEFERRED_FORMAT时只保存参数 */
+static void bench_fmt_int(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        logi("sensor %d value %d.%02d state %s", (int)(i & 7), (int)(i % 1000), (int)(i % 100), (i & 1) ? "on" : "off");
+    }
+}
+
+static void bench_fmt_float(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        logi("temp %.2f adc %u", (double)i * 0.01, i & 0xFFF);
+    }
+}
+
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+static void bench_fmt_read_back(uint32_t count)
+{
+    static char data[4096];
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        logi("sensor %d value %d.%02d state %s", (int)(i & 7), (int)(i % 1000), (int)(i % 100), (i & 1) ? "on" : "off");
+        if (i % 50 == 49)
+        {
+            flog_read_all(data, sizeof(data));
+        }
+    }
+}
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+
+/* 数字转换场景: 十六进制输出, 事件日志, 行号字段 */
+static uint8_t bench_hex_data[1024];
+
+static void bench_hex_byte(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        flog_hex_dump("bench", bench_hex_data, sizeof(bench_hex_data), FLOG_DATA_TYPE_BYTE);
+    }
+}
+
+static void bench_hex_half_word(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        flog_hex_dump("bench", bench_hex_data, sizeof(bench_hex_data), FLOG_DATA_TYPE_HALF_WORD);
+    }
+}
+
+static void bench_hex_word(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        flog_hex_dump("bench", bench_hex_data, sizeof(bench_hex_data), FLOG_DATA_TYPE_WORD);
+    }
+}
+
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+static void bench_event(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        log_event(FLOG_EVENT_0, "event line %u", i);
+    }
+}
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+
+static void bench_fmt_line(uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i)
+    {
+        logi("line field %u", i);
+    }
+}
+
+/**
+ * @brief 多线程场景的写日志线程
+ * @param arg 未使用
+ * @return NULL
+ */
+static void *bench_worker(void *arg)
+{
+    (void)arg;
+    for (uint32_t i = 0; i < bench_lines; ++i)
+    {
+        logi("worker line %u value %d", i, (int)(i * 7));
+    }
+    return NULL;
+}
+
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+/**
+ * @brief 扩展性场景的读取线程, 持续读取全部环形缓冲区
+ * @param arg 返回读取的字节数(uint64_t)
+ * @return NULL
+ */
+static void *bench_reader(void *arg)
+{
+    static char data[2048];
+    uint64_t *read_bytes = arg;
+    while (bench_reading)
+    {
+        uint32_t size = flog_read_all(data, sizeof(data));
+        *read_bytes += size;
+        if (size == 0)
+        {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+
+/**
+ * @brief 启动生产者线程并等待结束
+ * @param thread_num 线程数
+ * @return 耗时, 纳秒
+ */
+static double bench_run_workers(uint32_t thread_num)
+{
+    pthread_t *threads = malloc(sizeof(pthread_t) * thread_num);
+    double start = bench_now();
+    for (uint32_t i = 0; i < thread_num; ++i)
+    {
+        pthread_create(&threads[i], NULL, bench_worker, NULL);
+    }
+    for (uint32_t i = 0; i < thread_num; ++i)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    double elapsed = bench_now() - start;
+    free(threads);
+    return elapsed;
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t thread_num = 4;
+    double start = 0;
+    if (argc > 1)
+    {
+        bench_lines = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+    if (argc > 2)
+    {
+        thread_num = (uint32_t)strtoul(argv[2], NULL, 10);
+    }
+#if defined(FLEXILOG_USE_RING_BUFFER) && !defined(FLEXILOG_AUTO_MALLOC)
+    static char all_buffer[5 * 1024];
+    static char output_buffer[2 * 1024];
+    static char record_buffer[1024];
+    static char event_buffer[1024];
+    FLOG_RingBuffer_Init_Paremeter ring_buffer_paremeter = {
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+            .all_log_buffer = all_buffer,
+            .all_buffer_size = sizeof(all_buffer),
+#endif
+#if defined(FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
+            .output_log_buffer = output_buffer,
+            .output_buffer_size = sizeof(output_buffer),
+#endif
+#if defined(FLEXILOG_USE_RECOD_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
+            .recod_log_buffer = record_buffer,
+            .recod_buffer_size = sizeof(record_buffer),
+#endif
+#if defined(FLEXILOG_USE_EVENT_LOG_RING_BUFFER) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
+            .event_log_buffer = event_buffer,
+            .event_buffer_size = sizeof(event_buffer),
+#endif
+    };
+    (void)all_buffer; (void)output_buffer; (void)record_buffer; (void)event_buffer;
+    flog_port_linux_set_fd(open("/dev/null", O_WRONLY));
+    flog_init(&ring_buffer_paremeter);
+#else
+    flog_port_linux_set_fd(open("/dev/null", O_WRONLY));
+    flog_init();
+#endif
+    flog_set_global_filter(FLOG_LEVEL_INFO);
+
+    /* 被过滤的日志 */
+    start = bench_now();
+    for (uint32_t i = 0; i < bench_lines; ++i)
+    {
+        logd("filtered line %u", i);
+    }
+    printf("filtered         %8.1f ns/line\n", (bench_now() - start) / bench_lines);
+
+    /* 只写入环形缓冲区 */
+    flog_hardware_output_enable(false);
+    start = bench_now();
+    for (uint32_t i = 0; i < bench_lines; ++i)
+    {
+        logi("ring line %u value %d", i, (int)(i * 7));
+    }
+    printf("ring only        %8.1f ns/line\n", (bench_now() - start) / bench_lines);
+
+    /* 格式化开销, 与关闭FLEXILOG_USE_DEFERRED_FORMAT的编译结果对比 */
+    printf("fmt int/str      %8.1f ns/line\n", bench_best(bench_fmt_int, bench_lines));
+    printf("fmt float        %8.1f ns/line\n", bench_best(bench_fmt_float, bench_lines));
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+    printf("fmt + read back  %8.1f ns/line (flog_read_all every 50 lines)\n", bench_best(bench_fmt_read_back, bench_lines));
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+
+    /* 数字转换, 十六进制输出按每KB数据计时 */
+    for (uint32_t i = 0; i < sizeof(bench_hex_data); ++i)
+    {
+        bench_hex_data[i] = (uint8_t)(i * 37);
+    }
+    printf("hex dump byte    %8.1f us/KB\n", bench_best(bench_hex_byte, bench_lines / 100 + 1) / 1000);
+    printf("hex dump half    %8.1f us/KB\n", bench_best(bench_hex_half_word, bench_lines / 100 + 1) / 1000);
+    printf("hex dump word    %8.1f us/KB\n", bench_best(bench_hex_word, bench_lines / 100 + 1) / 1000);
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+    printf("event            %8.1f ns/line\n", bench_best(bench_event, bench_lines));
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+    flog_enable_fmt(FLOG_LEVEL_INFO, FLOG_FMT_LINE);
+    printf("fmt line field   %8.1f ns/line\n", bench_best(bench_fmt_line, bench_lines));
+    flog_disable_fmt(FLOG_LEVEL_INFO, FLOG_FMT_LINE);
+
+    /* 写入环形缓冲区并输出 */
+    flog_hardware_output_enable(true);
+    start = bench_now();
+    for (uint32_t i = 0; i < bench_lines; ++i)
+    {
+        logi("output line %u value %d", i, (int)(i * 7));
+    }
+    flog_flush();
+    printf("output           %8.1f ns/line\n", (bench_now() - start) / bench_lines);
+
+    /* 多线程竞争 */
+    if (thread_num > 0)
+    {
+        start = bench_now();
+        bench_run_workers(thread_num);
+        flog_flush();
+        printf("%2u threads       %8.1f ns/line\n", thread_num, (bench_now() - start) / ((double)bench_lines * thread_num));
+    }
+
+    /* 生产者扩展性: 只写入环形缓冲区, 同时有一个读取者 */
+    flog_hardware_output_enable(false);
+    for (uint32_t n = 1; n <= thread_num; n = (n < thread_num && n * 2 > thread_num) ? thread_num : n * 2)
+    {
+        uint64_t read_bytes = 0;
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+        pthread_t reader;
+        bench_reading = 1;
+        pthread_create(&reader, NULL, bench_reader, &read_bytes);
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+        double elapsed = bench_run_workers(n);
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+        bench_reading = 0;
+        pthread_join(reader, NULL);
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+        printf("scale %2u producers %6.2f Mlines/s, read %llu bytes\n", n,
+               (double)bench_lines * n * 1e3 / elapsed, (unsigned long long)read_bytes);
+        if (n == thread_num)
+        {
+            break;
+        }
+    }
+    flog_hardware_output_enable(true);
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+    printf("ring dropped     %8u lines\n", flog_ring_buffer_get_drop_count());
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+    printf("dropped bytes    %8llu\n", (unsigned long long)flog_port_linux_get_drop_count());
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+    flog_batch_stats_t stats;
+    flog_batch_get_stats(&stats);
+    printf("batch writes     %8u (%.1f lines, %.0f bytes per write)\n", stats.write_count,
+           stats.write_count ? (double)stats.line_count / stats.write_count : 0.0,
+           stats.write_count ? (double)stats.byte_count / stats.write_count : 0.0);
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    printf("batch waits      %8u\n", stats.wait_count);
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+    return 0;
+}
@@ -0,0 +1,681 @@
+/**
+ * ==================================================
+ *  @file flexi_log_port.c
+ *  @brief flexi log Linux移植
+ *  @note  输出写入文件描述符(默认标准输出), 锁为自适应自旋的futex, 时间使用vDSO的clock_gettime
+ *  @note  启用FLEXILOG_USE_ASYNC_OUTPUT时由flog_port_init()创建后台输出线程
+ *  @note  启用FLEXILOG_USE_OUTPUT_BATCH时由flog_port_init()创建线程按FLEXILOG_BATCH_DEADLINE_MS调用flog_batch_poll()
+ *  @note  启用FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER时由设备线程模拟慢速外设, 按设置的速率输出后调用flog_output_complete(), 并唤醒上面的线程
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-26 下午8:10
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include "flexi_log.h"
+#include "flexi_log_port_linux.h"
+
+/* your library */
+#include <errno.h>
+#include <linux/futex.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/prctl.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <time.h>
+#include <unistd.h>
+
+static int flog_linux_fd = STDOUT_FILENO;                   /* 输出的文件描述符 */
+static char flog_linux_pending[FLOG_LINUX_PENDING_SIZE];    /* 非阻塞fd暂时写不进去的数据 */
+static uint32_t flog_linux_pending_len = 0;
+static uint64_t flog_linux_drop_count = 0;                  /* 丢弃的字节数 */
+static _Atomic uint32_t flog_linux_lock_state = 0;          /* 0:未加锁 1:已加锁 2:已加锁且可能有等待者 */
+static uint32_t flog_linux_spin_count = FLOG_LINUX_SPIN_COUNT;
+static _Atomic uint32_t flog_linux_tid_generation = 1;      /* fork后递增, 使子进程重新获取线程ID */
+static pthread_once_t flog_linux_once = PTHREAD_ONCE_INIT;
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) && !defined(FLEXILOG_USE_NUMERIC_TIME)
+static uint64_t flog_linux_timestamp_base = 0;              /* 时间戳零点, 毫秒, 在flog_port_init()中设置后只读 */
+#endif
+
+void flog_port_lock(void);
+void flog_port_unlock(void);
+void flog_port_output(const char *buf, size_t size);
+
+/**
+ * @brief 自旋等待提示
+ */
+static inline void flog_linux_cpu_relax(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/**
+ * @brief futex等待
+ * @param word 等待的字
+ * @param value word仍等于该值时才进入等待
+ * @param timeout 超时时间, NULL表示一直等待
+ */
+static void flog_linux_futex_wait(_Atomic uint32_t *word, uint32_t value, const struct timespec *timeout)
+{
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAIT_PRIVATE, value, timeout, NULL, 0);
+}
+
+/**
+ * @brief futex唤醒
+ * @param word 等待的字
+ * @param count 唤醒的线程数
+ */
+static void flog_linux_futex_wake(_Atomic uint32_t *word, int count)
+{
+    syscall(SYS_futex, (uint32_t *)word, FUTEX_WAKE_PRIVATE, count, NULL, NULL, 0);
+}
+
+/**
+ * @brief fork后子进程的线程ID缓存失效
+ */
+static void flog_linux_atfork_child(void)
+{
+    atomic_fetch_add(&flog_linux_tid_generation, 1);
+}
+
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+static _Atomic uint32_t flog_linux_async_event = 0;     /* 每次唤醒递增 */
+static _Atomic uint32_t flog_linux_async_sleeping = 0;  /* 后台线程是否准备休眠 */
+static _Atomic uint32_t flog_linux_async_progress = 0;  /* 后台线程每输出一轮递增 */
+static _Atomic uint32_t flog_linux_async_waiters = 0;   /* 等待后台线程的线程数 */
+
+/**
+ * @brief 后台输出线程
+ * @param arg 未使用
+ * @return 不返回
+ */
+static void *flog_linux_async_task(void *arg)
+{
+    uint32_t event = 0;
+    (void)arg;
+    while (1)
+    {
+        event = atomic_load(&flog_linux_async_event);
+        flog_async_process();
+        atomic_fetch_add(&flog_linux_async_progress, 1);
+        if (atomic_load(&flog_linux_async_waiters))
+        {
+            flog_linux_futex_wake(&flog_linux_async_progress, INT32_MAX);
+        }
+
+        /* 先声明休眠再检查事件, 与flog_port_async_notify()配合不会丢失唤醒 */
+        atomic_store(&flog_linux_async_sleeping, 1);
+        if (atomic_load(&flog_linux_async_event) == event)
+        {
+            flog_linux_futex_wait(&flog_linux_async_event, event, NULL);
+        }
+        atomic_store(&flog_linux_async_sleeping, 0);
+    }
+    return NULL;
+}
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+static const char *flog_linux_device_buf = NULL;         /* 正在输出的数据 */
+static size_t flog_linux_device_size = 0;
+static struct timespec flog_linux_device_begin;          /* 启动输出的时刻 */
+static _Atomic uint32_t flog_linux_device_rate = 0;      /* 模拟设备的速率(字节/秒), 0表示不限速 */
+static _Atomic uint32_t flog_linux_device_start = 0;     /* 每次启动输出递增 */
+static _Atomic uint32_t flog_linux_device_done = 0;      /* 每次输出完成递增 */
+
+/**
+ * @brief 模拟设备线程
+ * @note  写入fd后定时到启动时刻加上按速率计算的传输时间, 再像完成中断一样调用flog_output_complete()
+ * @note  与中断一样不加日志锁, 写日志的线程可能持有锁等待本次输出完成
+ * @param arg 未使用
+ * @return 不返回
+ */
+static void *flog_linux_device_task(void *arg)
+{
+    uint32_t start = 0;
+    uint32_t rate = 0;
+    struct timespec end;
+    (void)arg;
+    /* 默认50us的定时器余量会拉长每次模拟的传输 */
+    prctl(PR_SET_TIMERSLACK, 1UL, 0, 0, 0);
+    while (1)
+    {
+        while (atomic_load(&flog_linux_device_start) == start)
+        {
+            flog_linux_futex_wait(&flog_linux_device_start, start, NULL);
+        }
+        start = atomic_load(&flog_linux_device_start);
+
+        /* 传输从启动时开始计时, 与本线程何时被调度无关 */
+        end = flog_linux_device_begin;
+        flog_port_output(flog_linux_device_buf, flog_linux_device_size);
+        rate = atomic_load(&flog_linux_device_rate);
+        if (rate > 0)
+        {
+            uint64_t ns = (uint64_t)flog_linux_device_size * 1000000000ULL / rate + (uint64_t)end.tv_nsec;
+            end.tv_sec += (time_t)(ns / 1000000000ULL);
+            end.tv_nsec = (long)(ns % 1000000000ULL);
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &end, NULL) == EINTR);
+        }
+
+        /* 对缓冲区的读取在释放之前完成 */
+        atomic_thread_fence(memory_order_release);
+        flog_output_complete();
+        atomic_fetch_add(&flog_linux_device_done, 1);
+        flog_linux_futex_wake(&flog_linux_device_done, INT32_MAX);
+    }
+    return NULL;
+}
+
+/**
+ * @brief 设置模拟设备的速率
+ * @param bytes_per_second 每秒输出的字节数, 例如115200波特率的串口约为11520, 0表示不限速
+ */
+void flog_port_linux_set_device_rate(uint32_t bytes_per_second)
+{
+    atomic_store(&flog_linux_device_rate, bytes_per_second);
+}
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+
+#if defined(FLEXILOG_USE_OUTPUT_BATCH) && ((FLEXILOG_BATCH_DEADLINE_MS > 0) || defined(FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER))
+/**
+ * @brief 合并输出的期限检查线程
+ * @note  没有新日志写入时, 暂存的日志最迟在两个期限内输出
+ * @note  双缓冲时设备每完成一次输出也唤醒一次, 启动输出期间被推迟的缓冲区
+ * @param arg 未使用
+ * @return 不返回
+ */
+static void *flog_linux_batch_task(void *arg)
+{
+#if (FLEXILOG_BATCH_DEADLINE_MS > 0)
+    const struct timespec period = {FLEXILOG_BATCH_DEADLINE_MS / 1000, (FLEXILOG_BATCH_DEADLINE_MS % 1000) * 1000000L};
+    const struct timespec *timeout = &period;
+#else
+    const struct timespec *timeout = NULL;
+#endif // FLEXILOG_BATCH_DEADLINE_MS > 0
+    (void)arg;
+    while (1)
+    {
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+        flog_linux_futex_wait(&flog_linux_device_done, atomic_load(&flog_linux_device_done), timeout);
+#else
+        nanosleep(timeout, NULL);
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+        flog_batch_poll();
+    }
+    return NULL;
+}
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) && !defined(FLEXILOG_USE_NUMERIC_TIME)
+/**
+ * @brief 获取当前时间
+ * @return 毫秒
+ */
+static uint64_t flog_linux_get_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    return (uint64_t)ts.tv_sec * 1000 + (uint64_t)ts.tv_nsec / 1000000;
+}
+#endif
+
+/**
+ * @brief 只执行一次的初始化
+ */
+static void flog_linux_init_once(void)
+{
+    tzset();
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) && !defined(FLEXILOG_USE_NUMERIC_TIME)
+    /* 在任何线程写日志前确定时间戳零点, 多个线程第一次写日志时不会各自设置 */
+    flog_linux_timestamp_base = flog_linux_get_ms();
+#endif
+    if (sysconf(_SC_NPROCESSORS_ONLN) <= 1)
+    {
+        flog_linux_spin_count = 0;
+    }
+    pthread_atfork(NULL, NULL, flog_linux_atfork_child);
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, flog_linux_async_task, NULL) == 0)
+    {
+        pthread_detach(thread);
+    }
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+#if defined(FLEXILOG_USE_OUTPUT_BATCH) && ((FLEXILOG_BATCH_DEADLINE_MS > 0) || defined(FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER))
+    pthread_t batch_thread;
+    if (pthread_create(&batch_thread, NULL, flog_linux_batch_task, NULL) == 0)
+    {
+        pthread_detach(batch_thread);
+    }
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    pthread_t device_thread;
+    atomic_store(&flog_linux_device_rate, FLOG_LINUX_DEVICE_RATE);
+    if (pthread_create(&device_thread, NULL, flog_linux_device_task, NULL) == 0)
+    {
+        pthread_detach(device_thread);
+    }
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+}
+
+/**
+ * @brief 硬件外设初始化
+ */
+void flog_port_init(void)
+{
+    pthread_once(&flog_linux_once, flog_linux_init_once);
+}
+
+/**
+ * @brief 设置输出的文件描述符
+ * @note  需要在输出日志前设置, 例如打开的日志文件或管道; fd为非阻塞时写不进去的数据会缓存到下次输出
+ * @param fd 文件描述符
+ */
+void flog_port_linux_set_fd(int fd)
+{
+    flog_port_lock();
+    flog_linux_fd = fd;
+    flog_linux_pending_len = 0;
+    flog_port_unlock();
+}
+
+/**
+ * @brief 获取丢弃的字节数
+ * @return 写入出错或缓存已满时丢弃的字节数
+ */
+uint64_t flog_port_linux_get_drop_count(void)
+{
+    uint64_t count;
+    flog_port_lock();
+    count = flog_linux_drop_count;
+    flog_port_unlock();
+    return count;
+}
+
+/**
+ * @brief 缓存未写完的数据
+ * @param data 数据
+ * @param size 数据长度
+ */
+static void flog_linux_pending_append(const char *data, size_t size)
+{
+    size_t free_size = sizeof(flog_linux_pending) - flog_linux_pending_len;
+    if (size > free_size)
+    {
+        flog_linux_drop_count += size - free_size;
+        size = free_size;
+    }
+    memcpy(flog_linux_pending + flog_linux_pending_len, data, size);
+    flog_linux_pending_len += (uint32_t)size;
+}
+
+/**
+ * @brief 硬件外设输出
+ * @note  上次没写完的数据和本次数据用一次writev写入, 处理部分写入和EINTR
+ * @note  调用者保证串行: 同步输出在日志锁内调用, 异步输出只由后台线程调用
+ * @param buf 输出数据
+ * @param size 输出数据长度
+ */
+void flog_port_output(const char *buf, size_t size)
+{
+    struct iovec iov[2];
+    int iov_index = 0;
+    int iov_num = 0;
+    size_t written = 0;
+    ssize_t ret = 0;
+    if (flog_linux_pending_len > 0)
+    {
+        iov[iov_num].iov_base = flog_linux_pending;
+        iov[iov_num].iov_len = flog_linux_pending_len;
+        iov_num++;
+    }
+    iov[iov_num].iov_base = (void *)buf;
+    iov[iov_num].iov_len = size;
+    iov_num++;
+
+    while (iov_index < iov_num)
+    {
+        ret = writev(flog_linux_fd, &iov[iov_index], iov_num - iov_index);
+        if (ret < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            break;
+        }
+        written += (size_t)ret;
+        while (iov_index < iov_num && (size_t)ret >= iov[iov_index].iov_len)
+        {
+            ret -= (ssize_t)iov[iov_index].iov_len;
+            iov_index++;
+        }
+        if (iov_index < iov_num)
+        {
+            iov[iov_index].iov_base = (char *)iov[iov_index].iov_base + ret;
+            iov[iov_index].iov_len -= (size_t)ret;
+        }
+    }
+    if (iov_index == iov_num)
+    {
+        flog_linux_pending_len = 0;
+        return;
+    }
+
+    /* fd暂时写不进去时保留剩余数据, 其他错误直接丢弃 */
+    if (errno != EAGAIN && errno != EWOULDBLOCK)
+    {
+        flog_linux_drop_count += flog_linux_pending_len + size - written;
+        flog_linux_pending_len = 0;
+        return;
+    }
+    if (written < flog_linux_pending_len)
+    {
+        memmove(flog_linux_pending, flog_linux_pending + written, flog_linux_pending_len - written);
+        flog_linux_pending_len -= (uint32_t)written;
+        flog_linux_pending_append(buf, size);
+    }
+    else
+    {
+        written -= flog_linux_pending_len;
+        flog_linux_pending_len = 0;
+        flog_linux_pending_append(buf + written, size - written);
+    }
+}
+
+/**
+ * @brief 加锁
+ * @note  无竞争时一次CAS; 有竞争时先自旋等待, 超过FLOG_LINUX_SPIN_COUNT次后进入futex等待
+ */
+void flog_port_lock(void)
+{
+    uint32_t state = 0;
+    uint32_t spin = 0;
+    while (1)
+    {
+        state = 0;
+        if (atomic_compare_exchange_strong_explicit(&flog_linux_lock_state, &state, 1,
+                                                  memory_order_acquire, memory_order_relaxed))
+        {
+            return;
+        }
+        if (state == 2 || spin >= flog_linux_spin_count)
+        {
+            break;
+        }
+        /* 只读自旋, 不反复抢占缓存行 */
+        while (spin < flog_linux_spin_count && atomic_load_explicit(&flog_linux_lock_state, memory_order_relaxed) != 0)
+        {
+            flog_linux_cpu_relax();
+            spin++;
+        }
+    }
+
+    state = atomic_exchange_explicit(&flog_linux_lock_state, 2, memory_order_acquire);
+    while (state != 0)
+    {
+        flog_linux_futex_wait(&flog_linux_lock_state, 2, NULL);
+        state = atomic_exchange_explicit(&flog_linux_lock_state, 2, memory_order_acquire);
+    }
+}
+
+/**
+ * @brief 解锁
+ * @note  只有可能存在等待者时才进行系统调用
+ */
+void flog_port_unlock(void)
+{
+    if (atomic_exchange_explicit(&flog_linux_lock_state, 0, memory_order_release) == 2)
+    {
+        flog_linux_futex_wake(&flog_linux_lock_state, 1);
+    }
+}
+
+/**
+ * @brief 格式化到秒的本地时间
+ * @param second 秒
+ * @param buf 输出缓冲区
+ * @param size 输出缓冲区大小
+ * @return 长度
+ */
+static uint32_t flog_linux_format_second(time_t second, char *buf, uint32_t size)
+{
+    struct tm tm;
+    localtime_r(&second, &tm);
+    return (uint32_t)strftime(buf, size, "%Y-%m-%d %H:%M:%S", &tm);
+}
+
+#if defined(FLEXILOG_USE_NUMERIC_TIME) || defined(FLEXILOG_USE_OUTPUT_BATCH)
+/**
+ * @brief 获取tick
+ * @note  CLOCK_REALTIME按FLEXILOG_TICKS_PER_SECOND换算, glibc通过vDSO读取, 不进入内核
+ */
+uint64_t flog_port_get_ticks(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+#if (FLEXILOG_TICKS_PER_SECOND >= 1000000000)
+    return (uint64_t)ts.tv_sec * FLEXILOG_TICKS_PER_SECOND + (uint64_t)ts.tv_nsec * (FLEXILOG_TICKS_PER_SECOND / 1000000000);
+#else
+    return (uint64_t)ts.tv_sec * FLEXILOG_TICKS_PER_SECOND + (uint64_t)ts.tv_nsec / (1000000000 / FLEXILOG_TICKS_PER_SECOND);
+#endif
+}
+#endif
+
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+/**
+ * @brief 格式化秒以上的时间
+ * @param second 秒, 即tick / FLEXILOG_TICKS_PER_SECOND
+ * @param buf 输出缓冲区
+ * @param size 输出缓冲区大小
+ */
+void flog_port_format_seconds(uint64_t second, char *buf, uint32_t size)
+{
+    if (flog_linux_format_second((time_t)second, buf, size) == 0 && size > 0)
+    {
+        buf[0] = '\0';
+    }
+}
+#else
+/**
+ * @brief 获取时间
+ * @note  每个线程缓存到秒的文本, 同一秒内只更新毫秒
+ */
+const char *flog_port_get_time(void)
+{
+    static __thread char text[32];
+    static __thread time_t second = -1;
+    static __thread uint32_t second_len = 0;
+    struct timespec ts;
+    uint32_t ms = 0;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    if (ts.tv_sec != second)
+    {
+        second_len = flog_linux_format_second(ts.tv_sec, text, sizeof(text) - 5);
+        second = ts.tv_sec;
+    }
+    ms = (uint32_t)(ts.tv_nsec / 1000000);
+    text[second_len] = '.';
+    text[second_len + 1] = (char)('0' + ms / 100);
+    text[second_len + 2] = (char)('0' + ms / 10 % 10);
+    text[second_len + 3] = (char)('0' + ms % 10);
+    text[second_len + 4] = '\0';
+    return text;
+}
+#endif
+
+/**
+ * @brief 获取线程ID
+ * @note  每个线程只调用一次gettid, fork后的子进程重新获取
+ */
+const char *flog_port_get_thread(void)
+{
+    static __thread char text[16];
+    static __thread uint32_t generation = 0;
+    uint32_t current = atomic_load_explicit(&flog_linux_tid_generation, memory_order_relaxed);
+    if (generation != current)
+    {
+        char digits[12];
+        uint32_t len = 0;
+        uint32_t pos = 0;
+        unsigned long tid = (unsigned long)syscall(SYS_gettid);
+        do
+        {
+            digits[len++] = (char)('0' + tid % 10);
+            tid /= 10;
+        } while (tid > 0 && len < sizeof(digits));
+        while (len > 0)
+        {
+            text[pos++] = digits[--len];
+        }
+        text[pos] = '\0';
+        generation = current;
+    }
+    return text;
+}
+
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) && !defined(FLEXILOG_USE_NUMERIC_TIME)
+/**
+ * @brief 获取时间戳
+ * @note  flog_port_init()之后经过的毫秒数, 约49天回绕一次
+ */
+uint32_t flog_port_get_timestamp(void)
+{
+    return (uint32_t)(flog_linux_get_ms() - flog_linux_timestamp_base);
+}
+
+/**
+ * @brief 时间戳转换为时间字符串
+ * @note  输出格式与flog_port_get_time()一致
+ * @param timestamp 时间戳
+ * @param buf 输出缓冲区
+ * @param size 输出缓冲区大小
+ */
+void flog_port_format_timestamp(uint32_t timestamp, char *buf, uint32_t size)
+{
+    uint64_t ms = flog_linux_timestamp_base + timestamp;
+    uint32_t len = 0;
+    if (size < 5)
+    {
+        if (size > 0)
+        {
+            buf[0] = '\0';
+        }
+        return;
+    }
+    len = flog_linux_format_second((time_t)(ms / 1000), buf, size - 4);
+    buf[len] = '.';
+    buf[len + 1] = (char)('0' + ms % 1000 / 100);
+    buf[len + 2] = (char)('0' + ms % 100 / 10);
+    buf[len + 3] = (char)('0' + ms % 10);
+    buf[len + 4] = '\0';
+}
+#endif
+
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+/**
+ * @brief 让出CPU
+ */
+void flog_port_yield(void)
+{
+    sched_yield();
+}
+#endif
+
+#if defined(FLEXILOG_USE_THREAD_CONTEXT) && !defined(FLEXILOG_THREAD_LOCAL)
+/**
+ * @brief 获取当前线程的格式化上下文
+ */
+flog_context_t *flog_port_get_context(void)
+{
+    static __thread flog_context_t context;
+    return &context;
+}
+#endif
+
+#ifdef FLEXILOG_AUTO_MALLOC
+/**
+ * @brief 内存分配
+ */
+void *flog_port_malloc(size_t size)
+{
+    return malloc(size);
+}
+
+/**
+ * @brief 内存释放
+ */
+void flog_port_free(void *ptr)
+{
+    free(ptr);
+}
+#endif
+
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+/**
+ * @brief 启动异步输出
+ * @note  交给设备线程后立即返回, 核心保证上一次输出完成后才会再次调用
+ * @param buf 输出数据
+ * @param size 输出数据长度
+ */
+void flog_port_output_async(const char *buf, size_t size)
+{
+    clock_gettime(CLOCK_MONOTONIC, &flog_linux_device_begin);
+    flog_linux_device_buf = buf;
+    flog_linux_device_size = size;
+    atomic_fetch_add(&flog_linux_device_start, 1);
+    flog_linux_futex_wake(&flog_linux_device_start, 1);
+}
+
+/**
+ * @brief 等待异步输出完成
+ * @note  等待设备线程完成一次输出, 最多1ms
+ */
+void flog_port_output_wait(void)
+{
+    const struct timespec timeout = {0, 1000000};
+    flog_linux_futex_wait(&flog_linux_device_done, atomic_load(&flog_linux_device_done), &timeout);
+}
+#endif
+
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+/**
+ * @brief 唤醒后台输出线程
+ * @note  后台线程没有休眠时不进行系统调用
+ */
+void flog_port_async_notify(void)
+{
+    atomic_fetch_add(&flog_linux_async_event, 1);
+    if (atomic_load(&flog_linux_async_sleeping))
+    {
+        flog_linux_futex_wake(&flog_linux_async_event, 1);
+    }
+}
+
+/**
+ * @brief 等待后台输出线程
+ * @note  等待后台线程完成一轮输出, 最多1ms
+ */
+void flog_port_async_wait(void)
+{
+    const struct timespec timeout = {0, 1000000};
+    uint32_t progress = 0;
+    atomic_fetch_add(&flog_linux_async_waiters, 1);
+    progress = atomic_load(&flog_linux_async_progress);
+    flog_linux_futex_wait(&flog_linux_async_progress, progress, &timeout);
+    atomic_fetch_sub(&flog_linux_async_waiters, 1);
+}
+#endif
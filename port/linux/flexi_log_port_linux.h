@@ -0,0 +1,28 @@
+/**
+ * ==================================================
+ *  @file flexi_log_port_linux.h
+ *  @brief flexi log Linux移植接口
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-26 下午8:10
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#ifndef FLEXILOG_FLEXI_LOG_PORT_LINUX_H
+#define FLEXILOG_FLEXI_LOG_PORT_LINUX_H
+
+#include "stdint.h"
+#include "flexi_log.h"
+
+#define FLOG_LINUX_PENDING_SIZE (64 * 1024)  /* 非阻塞fd暂时写不进去的数据的缓存大小 */
+#define FLOG_LINUX_SPIN_COUNT   100          /* 加锁进入futex等待前的自旋次数, 单核时不自旋 */
+#define FLOG_LINUX_DEVICE_RATE  0            /* 双缓冲时模拟设备的默认速率(字节/秒), 0表示不限速 */
+
+void flog_port_linux_set_fd(int fd);
+uint64_t flog_port_linux_get_drop_count(void);
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+void flog_port_linux_set_device_rate(uint32_t bytes_per_second);
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+#endif //FLEXILOG_FLEXI_LOG_PORT_LINUX_H
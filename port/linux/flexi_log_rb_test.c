@@ -0,0 +1,211 @@
+/**
+ * ==================================================
+ *  @file flexi_log_rb_test.c
+ *  @brief flexi log 环形缓冲区差分测试
+ *  @note  用法: flexi_log_rb_test [随机种子], 对同一组随机的写入/读取/整行读取操作,
+ *         比较flog_rb_*与逐字节拷贝的参考实现, 每次操作后检查返回数据、缓冲区内容和读写位置
+ *  @note  参考实现是批量拷贝之前的逐字节版本, 作为行为基准保留在这里
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-28 下午9:20
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+#include "flexi_log.h"
+#include "flexi_log_rb.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(FLEXILOG_USE_RING_BUFFER) || defined(FLEXILOG_USE_ASYNC_OUTPUT)
+#define TEST_ROUNDS         2000    /* 缓冲区大小的随机轮数 */
+#define TEST_OPS_PER_ROUND  2000    /* 每轮的操作次数 */
+#define TEST_MAX_SIZE       97      /* 最大缓冲区大小 */
+
+/* 参考环形缓冲区, 与默认模式的flog_ring_buffer_t布局相同 */
+typedef struct
+{
+    char *buffer;
+    uint32_t size;
+    uint32_t read_pos : 31;
+    uint32_t read_pos_mirror : 1;
+    uint32_t write_pos : 31;
+    uint32_t write_pos_mirror : 1;
+}ref_rb_t;
+
+static void ref_rb_init(ref_rb_t *rb, char *buffer, uint32_t size)
+{
+    memset(buffer, 0, size);
+    rb->buffer = buffer;
+    rb->size = size;
+    rb->read_pos = 0;
+    rb->write_pos = 0;
+    rb->read_pos_mirror = 0;
+    rb->write_pos_mirror = 0;
+}
+
+static bool ref_rb_is_empty(ref_rb_t *rb)
+{
+    return (rb->read_pos == rb->write_pos && rb->read_pos_mirror == rb->write_pos_mirror);
+}
+
+static bool ref_rb_is_full(ref_rb_t *rb)
+{
+    return (rb->read_pos == rb->write_pos && rb->read_pos_mirror != rb->write_pos_mirror);
+}
+
+static uint32_t ref_rb_get_used(ref_rb_t *rb)
+{
+    if (ref_rb_is_full(rb))
+    {
+        return rb->size;
+    }
+    return (rb->write_pos + rb->size - rb->read_pos) % rb->size;
+}
+
+static uint32_t ref_rb_read(ref_rb_t *rb, char *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (ref_rb_is_empty(rb))
+        {
+            return i;
+        }
+        data[i] = rb->buffer[rb->read_pos];
+        rb->read_pos = (rb->read_pos + 1) % rb->size;
+        if (rb->read_pos == 0)
+        {
+            rb->read_pos_mirror = !rb->read_pos_mirror;
+        }
+    }
+    return size;
+}
+
+static uint32_t ref_rb_read_lines(ref_rb_t *rb, char *data, uint32_t size)
+{
+    if (ref_rb_is_empty(rb))
+        return 0;
+    uint32_t try_read_pos = rb->read_pos;
+    uint32_t read_size = 0;
+    uint32_t try_read_size = 0;
+    char rChar = 0;
+    while (1)
+    {
+        rChar = rb->buffer[try_read_pos];
+        try_read_size++;
+        try_read_pos = (try_read_pos + 1) % rb->size;
+        if (try_read_size >= size)
+        {
+            break;
+        }
+        if (try_read_pos == rb->write_pos)
+        {
+            read_size = try_read_size;
+            break;
+        }
+        if (rChar == '\n')
+        {
+            read_size = try_read_size;
+        }
+    }
+    return ref_rb_read(rb, data, read_size);
+}
+
+static void ref_rb_write_force(ref_rb_t *rb, const char *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i)
+    {
+        if (ref_rb_is_full(rb))
+        {
+            rb->read_pos = (rb->read_pos + 1) % rb->size;
+            if (rb->read_pos == 0)
+            {
+                rb->read_pos_mirror = !rb->read_pos_mirror;
+            }
+        }
+        rb->buffer[rb->write_pos] = data[i];
+        rb->write_pos = (rb->write_pos + 1) % rb->size;
+        if (rb->write_pos == 0)
+        {
+            rb->write_pos_mirror = !rb->write_pos_mirror;
+        }
+    }
+}
+
+/**
+ * @brief 比较两个缓冲区的状态
+ * @param rb 被测环形缓冲区
+ * @param ref 参考环形缓冲区
+ * @return 是否一致
+ */
+static bool test_same_state(flog_ring_buffer_t *rb, ref_rb_t *ref)
+{
+    if (memcmp(rb->buffer, ref->buffer, ref->size) != 0 || flog_rb_get_used(rb) != ref_rb_get_used(ref))
+    {
+        return false;
+    }
+#ifdef FLEXILOG_USE_POW2_RING_BUFFER
+    return (rb->read_pos & rb->mask) == ref->read_pos && (rb->write_pos & rb->mask) == ref->write_pos;
+#else
+    return rb->read_pos == ref->read_pos && rb->write_pos == ref->write_pos
+           && rb->read_pos_mirror == ref->read_pos_mirror && rb->write_pos_mirror == ref->write_pos_mirror;
+#endif // FLEXILOG_USE_POW2_RING_BUFFER
+}
+
+int main(int argc, char **argv)
+{
+    static char rb_buffer[TEST_MAX_SIZE], ref_buffer[TEST_MAX_SIZE];
+    static char in[3 * TEST_MAX_SIZE + 2], out[3 * TEST_MAX_SIZE + 2], ref_out[3 * TEST_MAX_SIZE + 2];
+    unsigned long ops = 0;
+    srand(argc > 1 ? (unsigned)strtoul(argv[1], NULL, 10) : 1);
+    for (int round = 0; round < TEST_ROUNDS; ++round)
+    {
+        flog_ring_buffer_t rb;
+        ref_rb_t ref;
+        flog_rb_init(&rb, rb_buffer, 1 + (uint32_t)rand() % TEST_MAX_SIZE);
+        ref_rb_init(&ref, ref_buffer, rb.size);
+        for (int k = 0; k < TEST_OPS_PER_ROUND; ++k, ++ops)
+        {
+            int op = rand() % 3;
+            /* 大多数操作不超过缓冲区大小, 少数超过缓冲区大小以覆盖整块覆盖的情况 */
+            uint32_t n = (uint32_t)rand() % ((rand() % 4) ? rb.size + 2 : 3 * rb.size + 1);
+            uint32_t size = 0, ref_size = 0;
+            for (uint32_t i = 0; i < n; ++i)
+            {
+                in[i] = (rand() % 5 == 0) ? '\n' : (char)('a' + rand() % 26);
+            }
+            if (op == 0)
+            {
+                flog_rb_write_force(&rb, in, n);
+                ref_rb_write_force(&ref, in, n);
+            }
+            else if (op == 1)
+            {
+                size = flog_rb_read(&rb, out, n);
+                ref_size = ref_rb_read(&ref, ref_out, n);
+            }
+            else
+            {
+                size = flog_rb_read_lines(&rb, out, n + 1);
+                ref_size = ref_rb_read_lines(&ref, ref_out, n + 1);
+            }
+            if (size != ref_size || memcmp(out, ref_out, size) != 0 || !test_same_state(&rb, &ref))
+            {
+                printf("FAIL round %d op %d (%s, %u bytes, buffer %u)\n", round, k,
+                       op == 0 ? "write" : (op == 1 ? "read" : "read_lines"), n, rb.size);
+                return 1;
+            }
+        }
+    }
+    printf("ring buffer differential test passed, %lu ops\n", ops);
+    return 0;
+}
+#else
+int main(void)
+{
+    printf("ring buffer differential test skipped, FLEXILOG_USE_RING_BUFFER is disabled\n");
+    return 0;
+}
+#endif // FLEXILOG_USE_RING_BUFFER || FLEXILOG_USE_ASYNC_OUTPUT
@@ -12,60 +12,111 @@
 #include "flexi_log_until.h"
 #include "stdbool.h"
 #include "string.h"
-#include "stdio.h"
 #include "stdarg.h"
-#ifdef FLEXILOG_USE_RING_BUFFER
+#include "flexi_log_format.h"
+#if defined(FLEXILOG_USE_RING_BUFFER) || defined(FLEXILOG_USE_ASYNC_OUTPUT)
 #include "flexi_log_rb.h"
 #endif
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+#include "flexi_log_lfrb.h"
+#endif
+#ifdef FLEXILOG_USE_DEFERRED_FORMAT
+#include "flexi_log_defer.h"
+#endif
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+#include "flexi_log_filter.h"
+#endif
 
 #define FLOG_TAG "FLOG"
 #define FLOG_VERSION "1.0.0"
 
+/**
+ * @brief 日志环形缓冲区
+ * @note  启用FLEXILOG_USE_LOCK_FREE_RING_BUFFER时使用无锁环形缓冲区, 写入不需要加锁
+ * @note  启用FLEXILOG_USE_FRAMED_RING_BUFFER时按记录存储, 等级和序号只在记录格式下保存
+ * @note  启用FLEXILOG_USE_SHARED_RING_BUFFER时只有ring_buffer_all保存日志, 其他缓冲区是它的读取视图
+ */
+#ifdef FLEXILOG_USE_RING_BUFFER
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+typedef flog_lfrb_t flog_log_rb_t;
+#define flog_log_rb_init            flog_lfrb_init
+#define flog_log_rb_buffer_create   flog_lfrb_buffer_create
+#define flog_log_rb_read_lines      flog_lfrb_read_lines
+#define flog_log_rb_write(rb, data, size, level, target, sequence)  ((void)(level), (void)(target), (void)(sequence), flog_lfrb_write_force(rb, data, size))
+#elif defined(FLEXILOG_USE_FRAMED_RING_BUFFER)
+typedef flog_ring_buffer_t flog_log_rb_t;
+#define flog_log_rb_init            flog_rb_init
+#define flog_log_rb_buffer_create   flog_rb_buffer_create
+#define flog_log_rb_read_lines(rb, data, size)  flog_rb_read_records(rb, data, size, FLOG_RECORD_RENDER)
+#define flog_log_rb_write           flog_rb_write_record
+#else
+typedef flog_ring_buffer_t flog_log_rb_t;
+#define flog_log_rb_init            flog_rb_init
+#define flog_log_rb_buffer_create   flog_rb_buffer_create
+#define flog_log_rb_read_lines      flog_rb_read_lines
+#define flog_log_rb_write(rb, data, size, level, target, sequence)  ((void)(level), (void)(target), (void)(sequence), flog_rb_write_force(rb, data, size))
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+
+/**
+ * @brief 全部环形缓冲区的预留/提交
+ * @note  启用FLEXILOG_USE_ZERO_COPY_RING_BUFFER时日志直接格式化到预留空间, 提交时不需要再拷贝
+ */
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+#ifdef FLEXILOG_USE_FRAMED_RING_BUFFER
+#define flog_log_rb_reserve         flog_rb_reserve_record
+#define flog_log_rb_commit          flog_rb_commit_record
+#else
+#define flog_log_rb_reserve         flog_rb_reserve
+#define flog_log_rb_commit(rb, size, level, target, sequence)  ((void)(level), (void)(target), (void)(sequence), flog_rb_commit(rb, size))
+#endif // FLEXILOG_USE_FRAMED_RING_BUFFER
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+
+/**
+ * @brief 二进制记录渲染函数
+ * @note  启用FLEXILOG_USE_DEFERRED_FORMAT时, 只写入环形缓冲区的日志保存为二进制记录, 读取时再格式化
+ * @note  启用FLEXILOG_USE_BINARY_HEX_DUMP时, 十六进制输出保存原始数据, 读取时再渲染为表格
+ */
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) || defined(FLEXILOG_USE_BINARY_HEX_DUMP)
+static uint32_t flog_render_record(const flog_rb_record_t *head, const char *record, char *text, uint32_t size);
+#define FLOG_RECORD_RENDER flog_render_record
+#else
+#define FLOG_RECORD_RENDER NULL
+#endif // FLEXILOG_USE_DEFERRED_FORMAT || FLEXILOG_USE_BINARY_HEX_DUMP
+#endif // FLEXILOG_USE_RING_BUFFER
+
 /* flexi_log_port */
 extern void flog_port_init(void);
 extern void flog_port_output(const char *buf, size_t size);
 extern void flog_port_lock(void);
 extern void flog_port_unlock(void);
+#if defined(FLEXILOG_USE_NUMERIC_TIME) || defined(FLEXILOG_USE_OUTPUT_BATCH)
+extern uint64_t flog_port_get_ticks(void);
+#endif
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+extern void flog_port_format_seconds(uint64_t second, char *buf, uint32_t size);
+#else
 extern const char *flog_port_get_time(void);
+#endif // FLEXILOG_USE_NUMERIC_TIME
 extern const char *flog_port_get_thread(void);
 #ifdef FLEXILOG_AUTO_MALLOC
 extern void *flog_port_malloc(size_t size);
 extern void flog_port_free(void *ptr);
 #endif
-
-/**
- * @brief hex_dump函数宏
- */
-#define FLOG_HEX_DUMP_APPEND_ASCII(pos, data_byte)      do                                             \
-                                                        {                                              \
-                                                            if (pos % 16 == (16 - data_byte))          \
-                                                            {                                          \
-                                                                log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "    %s\r\n", ascii);\
-                                                                ascii_pos = 0;                         \
-                                                                if (log_size > sizeof(flog.line_buffer) - line_size)\
-                                                                {                       \
-                                                                    pos += data_byte;   \
-                                                                    goto output;        \
-                                                                }                       \
-                                                            }                           \
-                                                        }while(0)
-/**
- * @brief hex_dump函数宏
- */
-#define FLOG_HEX_DUMP_TAIL_DEEL(pos, data_byte)     do\
-                                                    {                                                 \
-                                                        if (pos % 16 != 0)                            \
-                                                        {                                             \
-                                                            uint16_t space_len = (16 - pos % 16) / data_byte * (data_byte * 2 + 1); \
-                                                            for (int i = 0; i < space_len; ++i) {\
-                                                                flog.line_buffer[log_size++] = ' ';\
-                                                            }\
-                                                            for (int i = 0; i < space_len / (data_byte * 2 + 1) * data_byte; ++i) {\
-                                                                ascii[(16 - i - 1)] = ' ';\
-                                                            }\
-                                                        log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "    %s\r\n", ascii);\
-                                                        }\
-                                                    }while(0)
+#if defined(FLEXILOG_USE_THREAD_CONTEXT) && !defined(FLEXILOG_THREAD_LOCAL)
+extern flog_context_t *flog_port_get_context(void);
+#endif
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+extern void flog_port_async_notify(void);
+extern void flog_port_async_wait(void);
+#endif
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+extern void flog_port_output_async(const char *buf, size_t size);
+extern void flog_port_output_wait(void);
+#endif
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) && !defined(FLEXILOG_USE_NUMERIC_TIME)
+extern uint32_t flog_port_get_timestamp(void);
+extern void flog_port_format_timestamp(uint32_t timestamp, char *buf, uint32_t size);
+#endif
 
 /**
  * @brief 颜色格式
@@ -125,6 +176,11 @@ extern void flog_port_free(void *ptr);
  */
 #define FLOG_NEW_LINE "\r\n"
 
+/**
+ * @brief tag表
+ */
+#define FLOG_TAG_INDEX_SIZE     (FLEXILOG_TAG_FILTER_NUM * 2)   /* tag哈希索引大小, 保持一半以上空位 */
+
 /**
  * @brief 默认格式
  */
@@ -152,6 +208,55 @@ extern void flog_port_free(void *ptr);
                             }                            \
                         }while(0)
 
+/**
+ * @brief 格式化加锁/解锁
+ * @note  共用格式化缓冲区时格式化过程需要在锁内进行, 线程独立缓冲区时只需要对写入过程加锁
+ */
+#ifdef FLEXILOG_USE_THREAD_CONTEXT
+#define FLOG_FORMAT_LOCK()
+#define FLOG_FORMAT_UNLOCK()
+#define FLOG_COMMIT_LOCK()      FLOG_LOCK()
+#define FLOG_COMMIT_UNLOCK()    FLOG_UNLOCK()
+#else
+#define FLOG_FORMAT_LOCK()      FLOG_LOCK()
+#define FLOG_FORMAT_UNLOCK()    FLOG_UNLOCK()
+#define FLOG_COMMIT_LOCK()
+#define FLOG_COMMIT_UNLOCK()
+#endif // FLEXILOG_USE_THREAD_CONTEXT
+
+/**
+ * @brief 读取环形缓冲区加锁/解锁
+ * @note  读取和写入同时进行会读到写了一半的数据, 记录格式下还会破坏记录头, 无锁环形缓冲区不需要加锁
+ */
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+#define FLOG_READ_LOCK()
+#define FLOG_READ_UNLOCK()
+#else
+#define FLOG_READ_LOCK()        FLOG_LOCK()
+#define FLOG_READ_UNLOCK()      FLOG_UNLOCK()
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+
+/**
+ * @brief 日志提交目标
+ */
+#define FLOG_TARGET_ALL         (0x01 << 0)     /* 全部环形缓冲区 */
+#define FLOG_TARGET_OUTPUT      (0x01 << 1)     /* 输出环形缓冲区 */
+#define FLOG_TARGET_RECOD       (0x01 << 2)     /* 记录环形缓冲区 */
+#define FLOG_TARGET_EVENT       (0x01 << 3)     /* 事件环形缓冲区 */
+#define FLOG_TARGET_HARDWARE    (0x01 << 4)     /* 硬件输出 */
+#define FLOG_TARGET_RESERVED    (0x01 << 5)     /* 日志已格式化在全部环形缓冲区的预留空间中 */
+
+/**
+ * @brief 行尾预留长度, 保证颜色重置和换行一定能写入
+ */
+#define FLOG_LINE_TAIL_LENGTH (sizeof(FLOG_COLOR_REST) + sizeof(FLOG_NEW_LINE))
+
+/**
+ * @brief 十六进制输出每行的字节数和不含标题的最大行长度(地址11 + 数据48 + 间隔4 + ascii16 + 换行2)
+ */
+#define FLOG_HEX_DUMP_ROW_BYTES     16
+#define FLOG_HEX_DUMP_ROW_LENGTH    81
+
 /**
  * @brief 文本颜色表
  */
@@ -212,420 +317,2289 @@ static const char *flog_level_str_table[FLOG_LEVEL_UNVALID] =
 };
 
 
+/**
+ * @brief 前缀中的动态字段
+ */
+typedef enum
+{
+    FLOG_PREFIX_FIELD_NONE = 0, /* 结尾 */
+    FLOG_PREFIX_FIELD_TIME,     /* 时间 */
+    FLOG_PREFIX_FIELD_TAG,      /* 标签 */
+    FLOG_PREFIX_FIELD_FILE,     /* 文件 */
+    FLOG_PREFIX_FIELD_LINE,     /* 行号 */
+    FLOG_PREFIX_FIELD_FUNC,     /* 函数 */
+    FLOG_PREFIX_FIELD_THREAD,   /* 线程 */
+    FLOG_PREFIX_FIELD_NUM
+}FLOG_PREFIX_FIELD;
+
+#define FLOG_PREFIX_TEXT_MAX_LENGTH 64  /* 前缀静态部分最大长度 */
+#define FLOG_PREFIX_STEP_MAX        12  /* 前缀最大步骤数量 */
+
+/**
+ * @brief 编译后的前缀
+ * @note  静态部分(颜色, 等级, 括号)预先拼接在text中, 每一步先拷贝len字节静态部分, 再填入一个动态字段
+ * @note  使用自定义格式时, 正文之后的静态部分保存在text末尾, 由tail_len记录长度
+ */
+typedef struct
+{
+    uint16_t fmt;                                   /* 编译时的格式 */
+    uint8_t step_num;                               /* 步骤数量 */
+    uint8_t text_len;                               /* 静态部分总长度 */
+    uint8_t tail_len;                               /* 正文之后的静态部分长度 */
+    uint8_t fields;                                 /* 用到的动态字段掩码, 第n位对应@ref FLOG_PREFIX_FIELD */
+    struct
+    {
+        uint8_t len;                                /* 静态部分长度 */
+        uint8_t field;                              /* 之后的动态字段 @ref FLOG_PREFIX_FIELD */
+    }steps[FLOG_PREFIX_STEP_MAX];
+    char text[FLOG_PREFIX_TEXT_MAX_LENGTH];         /* 静态部分 */
+}flog_prefix_t;
+
+#ifdef FLEXILOG_USE_SINK
+/**
+ * @brief 分发给输出器的日志
+ * @note  输出器的格式与等级格式不同时, 按这些字段重新拼接前缀, 正文直接拷贝
+ */
+typedef struct
+{
+    FLOG_LEVEL level;   /* 等级 */
+    const char *time;   /* 时间, 与默认格式使用同一个时间 */
+    const char *tag;    /* tag */
+    const char *file;   /* 文件名 */
+    const char *func;   /* 函数名 */
+    uint32_t line;      /* 行号 */
+    const char *body;   /* 格式化后的正文 */
+    uint32_t body_size; /* 正文长度 */
+}flog_sink_line_t;
+
+static void flog_sink_port_output(const char *buf, size_t size);
+static void flog_sink_output(const char *buf, uint32_t size, const flog_sink_line_t *line);
+#endif // FLEXILOG_USE_SINK
+
 /**
  * @brief FLOG 结构体
  */
 typedef struct
 {
-    char line_buffer[FLEXILOG_LINE_MAX_LENGTH];
+#ifndef FLEXILOG_USE_THREAD_CONTEXT
+    flog_context_t context;                     // 共用的格式化上下文
+#endif // FLEXILOG_USE_THREAD_CONTEXT
     uint16_t level_fmt[FLOG_LEVEL_UNVALID];          // 每个日志等级对应的格式
     FLOG_COLOR font_color[FLOG_LEVEL_UNVALID]; // 每个日志等级对应的字体颜色
     FLOG_COLOR bg_color[FLOG_LEVEL_UNVALID];     // 每个日志等级对应的背景颜色
+    flog_prefix_t prefix[FLOG_LEVEL_UNVALID];   // 每个日志等级编译后的前缀
+    const char *level_pattern[FLOG_LEVEL_UNVALID];  // 每个日志等级的自定义格式, NULL表示使用FLOG_FMT组合的默认格式
     bool hardware_output_enable;
     bool output_lock_enbale;
     bool output_color_enable;
     FLOG_LEVEL global_filter_level;
 
 #if (FLEXILOG_TAG_FILTER_NUM > 0)
-    struct flog_filter_t/* tag 过滤 */
+    struct flog_tag_t/* 注册的tag, 下标为tag编号 */
     {
         char tag[FLEXILOG_TAG_MAX_LENGTH + 1];
-        FLOG_LEVEL level;
-    }tag_filters[FLEXILOG_TAG_FILTER_NUM];
+        uint8_t level;                              // 规则计算出的过滤等级缓存, FLOG_FILTER_LEVEL_NONE表示使用全局过滤等级
+    }tags[FLEXILOG_TAG_FILTER_NUM];
+    uint16_t tag_num;                               // 已注册的tag数量
+    uint16_t tag_index[FLOG_TAG_INDEX_SIZE];        // tag哈希索引, 保存tag编号+1, 0表示空
+    flog_filter_t tag_rules;                        // tag过滤规则
 #endif // FLEXILOG_TAG_FILTER_NUM > 0
 
 #ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
-    flog_ring_buffer_t ring_buffer_all;
+    flog_log_rb_t ring_buffer_all;
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    flog_rb_view_t view_all;
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
 #endif  // FLEXILOG_USE_ALL_LOG_RING_BUFFER
 
 #ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    flog_ring_buffer_t ring_buffer_output;
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    flog_rb_view_t view_output;
+#else
+    flog_log_rb_t ring_buffer_output;
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
 #endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
 
 #ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
-    flog_ring_buffer_t ring_buffer_recod;
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    flog_rb_view_t view_recod;
+#else
+    flog_log_rb_t ring_buffer_recod;
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
     FLOG_LEVEL recod_level;
 #endif // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
 
 #ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
     struct flog_event_ring_buffer_t{
         FLOG_EVENT event;
-        flog_ring_buffer_t ring_bufer;
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+        flog_rb_view_t view;
+#else
+        flog_log_rb_t ring_bufer;
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
     }event_ring_buffer[FLOG_EVENT_NUM];
 #endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+
+#ifdef FLEXILOG_USE_FRAMED_RING_BUFFER
+    uint32_t sequence;  /* 日志序号 */
+#endif // FLEXILOG_USE_FRAMED_RING_BUFFER
+
+#ifdef FLEXILOG_USE_SINK
+    struct flog_sink_t/* 输出器 */
+    {
+        flog_sink_output_t output;                  // 输出函数, NULL表示未注册
+        bool enable;                                // 是否使能
+        FLOG_LEVEL level;                           // 最低输出等级
+        uint16_t fmt;                               // 保留的格式, 与等级格式按位与后使用 @ref FLOG_FMT
+        const char *pattern;                        // 自定义格式, NULL表示使用等级的自定义格式
+        uint32_t tag_mask;                          // tag掩码 @ref FLOG_SINK_TAG
+        flog_prefix_t prefix[FLOG_LEVEL_UNVALID];   // 格式与等级格式不同时编译的前缀
+    }sinks[FLEXILOG_SINK_NUM];
+    uint32_t sink_route[FLOG_LEVEL_UNVALID + 1];    // 每个等级要输出到的输出器掩码, 最后一项对应没有等级的输出
+    uint32_t sink_plan[FLOG_LEVEL_UNVALID];         // 每个等级使用独立前缀的输出器掩码
+#endif // FLEXILOG_USE_SINK
+
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+    struct flog_async_t/* 异步输出 */
+    {
+        flog_ring_buffer_t queue;                       // 待输出队列
+        char queue_buffer[FLEXILOG_ASYNC_QUEUE_SIZE];   // 队列缓冲区
+        char batch_buffer[FLEXILOG_ASYNC_BATCH_SIZE];   // 后台任务输出缓冲区
+        volatile bool busy;                             // 后台任务正在输出
+        FLOG_ASYNC_POLICY policy;                       // 队列满时的处理策略
+        uint32_t drop_count;                            // 丢弃的日志字节数
+    }async;
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+    struct flog_batch_t/* 合并输出 */
+    {
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+        char buffer[2][FLEXILOG_BATCH_BUFFER_SIZE]; // 双缓冲区, 一块输出时填充另一块
+        uint8_t fill;                               // 正在填充的缓冲区
+        volatile bool busy;                         // 另一块缓冲区正在输出
+        uint32_t *pending;                          // 输出中遇到的输出条件对应的统计项, NULL表示没有
+#else
+        char buffer[FLEXILOG_BATCH_BUFFER_SIZE];    // 暂存缓冲区
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+        uint32_t size;                              // 暂存的长度
+        uint64_t start_ticks;                       // 最早暂存的日志的tick
+        flog_batch_stats_t stats;                   // 统计
+    }batch;
+#endif // FLEXILOG_USE_OUTPUT_BATCH
 }flog_t;
 static flog_t flog;
 
+/* 快速过滤状态, 日志宏在求值参数之前读取 */
+volatile uint8_t flog_level_mask = 0;           /* 至少有一个tag能输出的等级掩码 */
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+volatile uint32_t flog_filter_generation = 0;   /* 过滤配置版本号, 变化后调用处的tag缓存失效 */
+#endif // FLEXILOG_TAG_FILTER_NUM > 0
+
+#if defined(FLEXILOG_USE_THREAD_CONTEXT) && defined(FLEXILOG_THREAD_LOCAL)
+static FLEXILOG_THREAD_LOCAL flog_context_t flog_thread_context;
+#endif
 
-#if defined(FLEXILOG_USE_RING_BUFFER) && !defined(FLEXILOG_AUTO_MALLOC)
 /**
- * @brief 静态初始化
- * @param parameter 静态初始化参数
+ * @brief 获取当前线程的格式化上下文
+ * @return 格式化上下文
  */
-void flog_init(FLOG_RingBuffer_Init_Paremeter *parameter)
+static flog_context_t *flog_get_context(void)
+{
+#ifndef FLEXILOG_USE_THREAD_CONTEXT
+    return &flog.context;
+#elif defined(FLEXILOG_THREAD_LOCAL)
+    return &flog_thread_context;
 #else
+    return flog_port_get_context();
+#endif
+}
+
+#ifdef FLEXILOG_USE_NUMERIC_TIME
 /**
- * @brief 初始化
+ * @brief 渲染时间文本
+ * @note  秒以上部分由flog_port_format_seconds()格式化后缓存在上下文中, 同一秒内只重新渲染秒以下的数字
+ * @param context 格式化上下文
+ * @param ticks tick
+ * @return 时间文本, 在上下文中保存到下一次渲染
  */
-void flog_init(void)
-#endif
+static const char *flog_time_render(flog_context_t *context, uint64_t ticks)
 {
-    flog_port_init();
-    flog.font_color[FLOG_LEVEL_DEBUG] = FLOG_COLOR_LIGHT_WHITE;
-    flog.font_color[FLOG_LEVEL_INFO] = FLOG_COLOR_GREEN;
-    flog.font_color[FLOG_LEVEL_WARN] = FLOG_COLOR_YELLOW;
-    flog.font_color[FLOG_LEVEL_ERROR] = FLOG_COLOR_RED;
-    flog.font_color[FLOG_LEVEL_RECORD] = FLOG_COLOR_PURPLE;
-    flog.font_color[FLOG_LEVEL_ASSERT] = FLOG_COLOR_WHITE;
-    flog.bg_color[FLOG_LEVEL_DEBUG] = FLOG_COLOR_UNVALID;
-    flog.bg_color[FLOG_LEVEL_INFO] = FLOG_COLOR_UNVALID;
-    flog.bg_color[FLOG_LEVEL_WARN] = FLOG_COLOR_UNVALID;
-    flog.bg_color[FLOG_LEVEL_ERROR] = FLOG_COLOR_UNVALID;
-    flog.bg_color[FLOG_LEVEL_RECORD] = FLOG_COLOR_UNVALID;
-    flog.bg_color[FLOG_LEVEL_ASSERT] = FLOG_COLOR_UNVALID;
-
-    flog.level_fmt[FLOG_LEVEL_DEBUG] = FLOG_FMT_DEFAULT;
-    flog.level_fmt[FLOG_LEVEL_INFO] = FLOG_FMT_DEFAULT;
-    flog.level_fmt[FLOG_LEVEL_WARN] = FLOG_FMT_DEFAULT;
-    flog.level_fmt[FLOG_LEVEL_ERROR] = FLOG_FMT_DEFAULT;
-    flog.level_fmt[FLOG_LEVEL_RECORD] = FLOG_FMT_DEFAULT | FLOG_FMT_THREAD | FLOG_FMT_FUNC;
-    flog.level_fmt[FLOG_LEVEL_ASSERT] = FLOG_FMT_DEFAULT | FLOG_FMT_THREAD | FLOG_FMT_FUNC;
-
-    flog.global_filter_level = FLOG_LEVEL_INFO;
-    flog.hardware_output_enable = true;
-    flog.output_lock_enbale = true;
-    flog.output_color_enable = true;
-
-
-#if (FLEXILOG_TAG_FILTER_NUM > 0)
-    memset(flog.tag_filters, 0, sizeof(flog.tag_filters));
-#endif // FLEXILOG_TAG_FILTER_NUM > 0
-
-#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
-    memset(&flog.ring_buffer_all, 0, sizeof(flog_ring_buffer_t));
-    #ifdef FLEXILOG_AUTO_MALLOC
-    flog_rb_buffer_create(&flog.ring_buffer_all, FLEXILOG_ALL_RING_BUFFER_SIZE);
-    #else
-    flexlog_assert(parameter->all_log_buffer != NULL);
-    flog_rb_init(&flog.ring_buffer_all, parameter->all_log_buffer, parameter->all_buffer_size);
-    #endif
-#endif  // FLEXILOG_USE_ALL_LOG_RING_BUFFER
-
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    memset(&flog.ring_buffer_output, 0, sizeof(flog_ring_buffer_t));
-    #ifdef FLEXILOG_AUTO_MALLOC
-    flog_rb_buffer_create(&flog.ring_buffer_output, FLEXILOG_OUTPUT_RING_BUFFER_SIZE);
-    #else
-    flexlog_assert(parameter->output_log_buffer != NULL);
-    flog_rb_init(&flog.ring_buffer_output, parameter->output_log_buffer, parameter->output_buffer_size);
-    #endif
-#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-
-#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
-    memset(&flog.ring_buffer_recod, 0, sizeof(flog_ring_buffer_t));
-    flog.recod_level = FLOG_LEVEL_RECORD;
-    #ifdef FLEXILOG_AUTO_MALLOC
-    flog_rb_buffer_create(&flog.ring_buffer_recod, FLEXILOG_RECOD_RING_BUFFER_SIZE);
-    #else
-    flexlog_assert(parameter->recod_log_buffer != NULL);
-    flog_rb_init(&flog.ring_buffer_recod, parameter->recod_log_buffer, parameter->recod_buffer_size);
-    #endif
-#endif // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
-
-#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
-    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+    uint64_t second = ticks / FLEXILOG_TICKS_PER_SECOND;
+    uint32_t fraction = (uint32_t)(ticks % FLEXILOG_TICKS_PER_SECOND);
+    char *text = context->time_text;
+    if (context->time_second_len == 0 || context->time_second != second)
     {
-        flog.event_ring_buffer[i].event = i;
-        #ifdef FLEXILOG_AUTO_MALLOC
-        flog_rb_buffer_create(&flog.event_ring_buffer[i].ring_bufer, FLEXILOG_EVENT_RING_BUFFER_SIZE / FLOG_EVENT_NUM);
-        #else
-        flexlog_assert(parameter->event_log_buffer != NULL);
-        uint32_t offset = i * parameter->event_buffer_size / FLOG_EVENT_NUM;
-        flog_rb_init(&flog.event_ring_buffer[i].ring_bufer, parameter->event_log_buffer + offset, parameter->event_buffer_size / FLOG_EVENT_NUM);
-        #endif
+        text[0] = '\0';
+        flog_port_format_seconds(second, text, FLEXILOG_TIME_TEXT_LENGTH - FLEXILOG_TIME_FRACTION_DIGITS - 1);
+        context->time_second = second;
+        context->time_second_len = (uint32_t)strlen(text);
     }
-#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
-    flog_printf(false, "Flexi Log init ok, version: %s\r\n", FLOG_VERSION);
+    text += context->time_second_len;
+#if (FLEXILOG_TIME_FRACTION_DIGITS > 0)
+    /* 逐位取秒以下的小数, 不会溢出 */
+    *text++ = '.';
+    for (int i = 0; i < FLEXILOG_TIME_FRACTION_DIGITS; ++i)
+    {
+        uint64_t scaled = (uint64_t)fraction * 10;
+        *text++ = (char)('0' + scaled / FLEXILOG_TICKS_PER_SECOND);
+        fraction = (uint32_t)(scaled % FLEXILOG_TICKS_PER_SECOND);
+    }
+#endif // FLEXILOG_TIME_FRACTION_DIGITS > 0
+    *text = '\0';
+    return context->time_text;
 }
 
-
-#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
-#ifndef FLEXILOG_AUTO_MALLOC
-void flog_set_ringbuffer_all(char *buffer, uint32_t size)
-{
-    flog_rb_init(&flog.ring_buffer_all, buffer, size);
-}
-#endif // FLEXILOG_AUTO_MALLOC
 /**
- * @brief 读取所有日志
- * @param data 输出缓冲区
- * @param size 缓冲区长度
- * @return 读取长度
+ * @brief 获取当前时间文本
+ * @return 时间文本
  */
-uint32_t flog_read_all(char *data, uint32_t size)
-{
-    return flog_rb_read_lines(&flog.ring_buffer_all, data, size);
-}
-#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-#ifndef FLEXILOG_AUTO_MALLOC
-void flog_set_ringbuffer_output(char *buffer, uint32_t size)
+static const char *flog_get_time(void)
 {
-    flog_rb_init(&flog.ring_buffer_all, buffer, size);
+    return flog_time_render(flog_get_context(), flog_port_get_ticks());
 }
-#endif // FLEXILOG_AUTO_MALLOC
+#else
+#define flog_get_time()     flog_port_get_time()
+#endif // FLEXILOG_USE_NUMERIC_TIME
+
+#ifdef FLEXILOG_USE_THREAD_NAME_CACHE
 /**
- * @brief 读取输出日志
- * @param data 输出缓冲区
- * @param size 缓冲区长度
- * @return 读取长度
+ * @brief 缓存线程名
+ * @param context 格式化上下文
+ * @param name 线程名, 超过FLEXILOG_THREAD_NAME_MAX_LENGTH时截断
  */
-uint32_t flog_read_output(char *data, uint32_t size)
+static void flog_thread_name_cache(flog_context_t *context, const char *name)
 {
-    return flog_rb_read_lines(&flog.ring_buffer_output, data, size);
+    uint32_t len = 0;
+    while (len < FLEXILOG_THREAD_NAME_MAX_LENGTH && name[len])
+    {
+        len++;
+    }
+    memcpy(context->thread_name, name, len);
+    context->thread_name[len] = '\0';
+    context->thread_name_len = len;
 }
-#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
 
-#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
-#ifndef FLEXILOG_AUTO_MALLOC
-void flog_set_ringbuffer_recod(char *buffer, uint32_t size)
-{
-    flog_rb_init(&flog.ring_buffer_recod, buffer, size);
-}
-#endif // FLEXILOG_AUTO_MALLOC
 /**
- * @brief 读取记录日志
- * @param data 输出缓冲区
- * @param size 缓冲区长度
- * @return 读取长度
+ * @brief 设置当前线程的线程名
+ * @note  只影响调用线程, 之后的日志直接使用缓存的线程名
+ * @param name 线程名, 例如"rx-worker-3", NULL表示重新从flog_port_get_thread()获取
  */
-uint32_t flog_read_record(char *data, uint32_t size)
-{
-    return flog_rb_read_lines(&flog.ring_buffer_recod, data, size);
-}
-#endif  // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
-
-#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
-#ifndef FLEXILOG_AUTO_MALLOC
-void flog_set_ringbuffer_event(char *buffer, uint32_t size)
+void flog_set_thread_name(const char *name)
 {
-    uint32_t offset = 0;
-    if (buffer)
+    flog_context_t *context = flog_get_context();
+    if (name == NULL)
     {
-        for (int i = 0; i < FLOG_EVENT_NUM; ++i)
-        {
-            offset = i * size / FLOG_EVENT_NUM;
-            flog.event_ring_buffer[i].event = i;
-            flog_rb_init(&flog.event_ring_buffer[i].ring_bufer, buffer + offset, size / FLOG_EVENT_NUM);
-        }
+        context->thread_name_len = 0;
+        return;
     }
+    flog_thread_name_cache(context, name);
 }
-#endif // FLEXILOG_AUTO_MALLOC
+
 /**
- * @brief 读取事件日志
- * @param event  事件
- * @param data 输出缓冲区
- * @param size 缓冲区长度
- * @return 读取长度
+ * @brief 获取当前线程的线程名
+ * @note  第一次调用时从flog_port_get_thread()获取并缓存
+ * @param len 返回线程名长度
+ * @return 线程名
  */
-uint32_t flog_read_event(FLOG_EVENT event, char *data, uint32_t size)
+static const char *flog_get_thread(uint32_t *len)
 {
-    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+    flog_context_t *context = flog_get_context();
+    if (context->thread_name_len == 0)
     {
-        if (flog.event_ring_buffer[i].event == event)
-        {
-            return flog_rb_read_lines(&flog.event_ring_buffer[i].ring_bufer, data, size);
-        }
+        flog_thread_name_cache(context, flog_port_get_thread());
     }
-    return 0;
+    *len = context->thread_name_len;
+    return context->thread_name;
 }
+#endif // FLEXILOG_USE_THREAD_NAME_CACHE
+
 
 /**
- * @brief 写入事件日志
- * @param event  事件
- * @param data 日志
- * @param size 日志长度
+ * @brief 前缀添加静态部分
+ * @param prefix 前缀
+ * @param str 静态字符串
+ * @param len 长度
+ * @param tail 是否在正文之后
+ * @return true 成功 false 静态部分已满
  */
-static void flog_write_event_ring_buffer(FLOG_EVENT event, char *data, uint32_t size)
+static bool flog_prefix_add(flog_prefix_t *prefix, const char *str, uint32_t len, bool tail)
 {
-    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
-    {
-        if (flog.event_ring_buffer[i].event == event)
-        {
-            flog_rb_write_force(&flog.event_ring_buffer[i].ring_bufer, data, size);
-        }
-    }
+    if (prefix->text_len + len > FLOG_PREFIX_TEXT_MAX_LENGTH)
+        return false;
+    memcpy(prefix->text + prefix->text_len, str, len);
+    prefix->text_len += len;
+    if (tail)
+        prefix->tail_len += len;
+    else
+        prefix->steps[prefix->step_num - 1].len += len;
+    return true;
 }
-#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
 
 /**
- * @brief 设置全局过滤等级
- * @param level 过滤等级
+ * @brief 前缀添加静态字符串
+ * @param prefix 前缀
+ * @param str 静态字符串
+ * @return true 成功 false 静态部分已满
  */
-void flog_set_global_filter(FLOG_LEVEL level)
+static bool flog_prefix_add_text(flog_prefix_t *prefix, const char *str)
 {
-    flog.global_filter_level = level;
+    return flog_prefix_add(prefix, str, strlen(str), false);
 }
 
-#if (FLEXILOG_TAG_FILTER_NUM > 0)
 /**
- * @brief 设置tag过滤等级
- * @param tag  tag
- * @param level 过滤等级
+ * @brief 前缀添加动态字段
+ * @param prefix 前缀
+ * @param field 动态字段 @ref FLOG_PREFIX_FIELD
+ * @return true 成功 false 步骤已满
  */
-void flog_set_tag_filter(const char *tag, FLOG_LEVEL level)
+static bool flog_prefix_add_field(flog_prefix_t *prefix, FLOG_PREFIX_FIELD field)
 {
-    for (int i = 0; i < FLEXILOG_TAG_FILTER_NUM; ++i)
-    {
-        if (flog.tag_filters[i].tag[0] == '\0')
-        {
-            strcpy(flog.tag_filters[i].tag, tag);
-            flog.tag_filters[i].level = level;
-            return;
-        }
-    }
+    if (prefix->step_num >= FLOG_PREFIX_STEP_MAX)
+        return false;
+    prefix->steps[prefix->step_num - 1].field = field;
+    prefix->fields |= 1U << field;
+    prefix->steps[prefix->step_num].len = 0;
+    prefix->steps[prefix->step_num].field = FLOG_PREFIX_FIELD_NONE;
+    prefix->step_num++;
+    return true;
 }
 
 /**
- * @brief 判断tag是否在过滤列表中
- * @param tag  tag
- * @return true     在过滤列表中
- * @return false    不在过滤列表中
+ * @brief 解析自定义格式
+ * @note  %T时间 %L等级 %t标签 %F文件 %l行号 %f函数 %h线程 %m正文 %%百分号, 其他字符原样输出
+ * @note  %m之后只能有静态字符, 没有%m时正文接在最后
+ * @param prefix 前缀
+ * @param level 等级
+ * @param pattern 自定义格式
+ * @return true 成功 false 格式错误或超出长度
  */
-static bool flog_is_tag_in_filter(const char *tag)
+static bool flog_prefix_parse(flog_prefix_t *prefix, FLOG_LEVEL level, const char *pattern)
 {
-    for (int i = 0; i < FLEXILOG_TAG_FILTER_NUM; ++i)
+    bool tail = false;
+    bool ok = true;
+    while (ok && *pattern)
     {
-        if (flog.tag_filters[i].tag[0] != '\0')
+        if (*pattern != '%')
         {
-            if (flog_strcmp(tag, flog.tag_filters[i].tag))
-            {
-                return true;
-            }
+            ok = flog_prefix_add(prefix, pattern++, 1, tail);
+            continue;
+        }
+        pattern++;
+        if (*pattern == '%')
+        {
+            ok = flog_prefix_add(prefix, pattern++, 1, tail);
+            continue;
+        }
+        if (tail)
+            return false;
+        switch (*pattern++)
+        {
+        case 'T': ok = flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_TIME); break;
+        case 'L': ok = flog_prefix_add_text(prefix, flog_level_str_table[level]); break;
+        case 't': ok = flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_TAG); break;
+        case 'F': ok = flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_FILE); break;
+        case 'l': ok = flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_LINE); break;
+        case 'f': ok = flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_FUNC); break;
+        case 'h': ok = flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_THREAD); break;
+        case 'm': tail = true; break;
+        default: return false;
         }
     }
-    return false;
+    return ok;
 }
 
 /**
- * @brief 获取tag过滤等级
- * @param tag  tag
- * @return FLOG_LEVEL  tag过滤等级
+ * @brief 编译前缀
+ * @note  等级的格式, 颜色或自定义格式改变后调用, 输出日志时只需要按步骤拷贝
+ * @note  使用自定义格式时, FLOG_FMT只决定颜色, 其他字段的顺序由自定义格式决定
+ * @param prefix 前缀
+ * @param level 等级
+ * @param fmt 格式 @ref FLOG_FMT
+ * @param pattern 自定义格式, NULL表示使用默认格式
+ * @return true 成功 false 自定义格式错误
  */
-static FLOG_LEVEL flog_get_tag_filter_level(const char *tag)
+static bool flog_prefix_compile(flog_prefix_t *prefix, FLOG_LEVEL level, uint16_t fmt, const char *pattern)
 {
-    for (int i = 0; i < FLEXILOG_TAG_FILTER_NUM; ++i)
+    memset(prefix, 0, sizeof(flog_prefix_t));
+    prefix->fmt = fmt;
+    prefix->step_num = 1;
+
+    /* 添加颜色 */
+    if (flog.output_color_enable && (fmt & (FLOG_FMT_FONT_COLOR | FLOG_FMT_BG_COLOR)))
     {
-        if (flog.tag_filters[i].tag[0] != '\0')
+        flog_prefix_add_text(prefix, FLOG_COLOR_START);
+        flog_prefix_add_text(prefix, flog_font_color_table[flog.font_color[level]]);
+        if (fmt & FLOG_FMT_BG_COLOR && flog.bg_color[level] != FLOG_COLOR_UNVALID)
         {
-            if (flog_strcmp(tag, flog.tag_filters[i].tag))
+            flog_prefix_add_text(prefix, FLOG_COLOR_ADD);
+            flog_prefix_add_text(prefix, flog_bg_color_table[flog.bg_color[level]]);
+        }
+        flog_prefix_add_text(prefix, FLOG_COLOR_END);
+    }
+
+    if (pattern != NULL)
+    {
+        return flog_prefix_parse(prefix, level, pattern);
+    }
+
+    /* 添加时间 */
+    if (fmt & FLOG_FMT_TIME)
+    {
+        flog_prefix_add_text(prefix, "[");
+        flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_TIME);
+        flog_prefix_add_text(prefix, "]");
+    }
+
+    /* 添加等级 */
+    if (fmt & FLOG_FMT_LEVEL)
+    {
+        flog_prefix_add_text(prefix, flog_level_str_table[level]);
+    }
+
+    /* 添加标签 */
+    if (fmt & FLOG_FMT_TAG)
+    {
+        flog_prefix_add_text(prefix, "[");
+        flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_TAG);
+        flog_prefix_add_text(prefix, "]");
+    }
+
+    /* 添加括号 */
+    if (fmt & (FLOG_FMT_FILE | FLOG_FMT_FUNC | FLOG_FMT_LINE))
+    {
+        flog_prefix_add_text(prefix, "(");
+        /* 添加文件 */
+        if (fmt & FLOG_FMT_FILE)
+            flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_FILE);
+    }
+
+    /* 添加行号 */
+    if (fmt & FLOG_FMT_LINE)
+    {
+        flog_prefix_add_text(prefix, ":");
+        flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_LINE);
+    }
+
+    /* 添加函数 */
+    if (fmt & FLOG_FMT_FUNC)
+    {
+        if (fmt & FLOG_FMT_LINE)
+        {
+            flog_prefix_add_text(prefix, ",");
+        }
+        flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_FUNC);
+        flog_prefix_add_text(prefix, "()");
+    }
+
+    /* 括号结尾 */
+    if (fmt & (FLOG_FMT_FILE | FLOG_FMT_FUNC | FLOG_FMT_LINE))
+    {
+        flog_prefix_add_text(prefix, ")");
+    }
+
+    /* 添加线程 */
+    if (fmt & FLOG_FMT_THREAD)
+    {
+        flog_prefix_add_text(prefix, "(theard:");
+        flog_prefix_add_field(prefix, FLOG_PREFIX_FIELD_THREAD);
+        flog_prefix_add_text(prefix, ")");
+    }
+    flog_prefix_add_text(prefix, ": ");
+    return true;
+}
+
+#ifdef FLEXILOG_USE_SINK
+/**
+ * @brief 编译输出器在某个等级的前缀
+ * @note  需要在加锁状态下调用, 格式和自定义格式都与等级相同的输出器直接使用等级的前缀, 不单独编译
+ * @note  编译失败的输出器使用等级的前缀
+ * @param level 等级
+ * @return true 成功 false 有输出器的前缀编译失败
+ */
+static bool flog_sink_compile(FLOG_LEVEL level)
+{
+    uint32_t plan = 0;
+    bool ok = true;
+    for (int i = 0; i < FLEXILOG_SINK_NUM; ++i)
+    {
+        struct flog_sink_t *sink = &flog.sinks[i];
+        uint16_t fmt = flog.level_fmt[level] & sink->fmt;
+        const char *pattern = sink->pattern ? sink->pattern : flog.level_pattern[level];
+        if (sink->output == NULL || (fmt == flog.level_fmt[level] && pattern == flog.level_pattern[level]))
+            continue;
+        if (!flog_prefix_compile(&sink->prefix[level], level, fmt, pattern))
+        {
+            ok = false;
+            continue;
+        }
+        plan |= 1U << i;
+    }
+    flog.sink_plan[level] = plan;
+    return ok;
+}
+
+/**
+ * @brief 重新计算输出器的路由和前缀
+ * @note  需要在加锁状态下调用, 输出器的注册, 使能, 等级和格式改变后调用
+ * @note  路由按等级预先计算为输出器掩码, 输出日志时只遍历掩码中的输出器
+ */
+static void flog_sink_update(void)
+{
+    for (int level = 0; level <= FLOG_LEVEL_UNVALID; ++level)
+    {
+        uint32_t route = 0;
+        for (int i = 0; i < FLEXILOG_SINK_NUM; ++i)
+        {
+            const struct flog_sink_t *sink = &flog.sinks[i];
+            /* 没有等级的输出(printf, 十六进制, 事件)发给所有使能的输出器 */
+            if (sink->output != NULL && sink->enable && (level == FLOG_LEVEL_UNVALID || (FLOG_LEVEL)level >= sink->level))
+                route |= 1U << i;
+        }
+        flog.sink_route[level] = route;
+        if (level < FLOG_LEVEL_UNVALID)
+            flog_sink_compile((FLOG_LEVEL)level);
+    }
+}
+#endif // FLEXILOG_USE_SINK
+
+/**
+ * @brief 更新等级的格式并重新编译前缀
+ * @note  编译失败时保留原来的格式和前缀, 输出器的前缀按当前的格式重新编译
+ * @param level 等级
+ * @param fmt 格式 @ref FLOG_FMT
+ * @param pattern 自定义格式, NULL表示使用默认格式
+ * @return true 成功 false 前缀超出长度或自定义格式错误
+ */
+static bool flog_prefix_update(FLOG_LEVEL level, uint16_t fmt, const char *pattern)
+{
+    flog_prefix_t prefix;
+    bool ok = flog_prefix_compile(&prefix, level, fmt, pattern);
+    FLOG_LOCK();
+    if (ok)
+    {
+        flog.level_fmt[level] = fmt;
+        flog.level_pattern[level] = pattern;
+        flog.prefix[level] = prefix;
+    }
+#ifdef FLEXILOG_USE_SINK
+    ok = flog_sink_compile(level) && ok;
+#endif // FLEXILOG_USE_SINK
+    FLOG_UNLOCK();
+    return ok;
+}
+
+/**
+ * @brief 过滤配置改变后重新计算等级掩码
+ * @note  掩码是所有tag能输出等级的并集, 为0的等级在日志宏中直接跳过, 不求值参数
+ */
+static void flog_update_filter(void)
+{
+    uint8_t mask = 0;
+#ifndef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+    bool enable = flog.hardware_output_enable;
+#else
+    bool enable = flog.ring_buffer_all.buffer != NULL;
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+    for (int level = 0; enable && level < FLOG_LEVEL_UNVALID; ++level)
+    {
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+        bool pass = (FLOG_LEVEL)level >= flog.global_filter_level;
+        for (int i = 0; !pass && i < flog.tag_rules.node_num; ++i)
+        {
+            const flog_filter_node_t *node = &flog.tag_rules.nodes[i];
+            if (node->level != FLOG_FILTER_LEVEL_NONE || node->wildcard_level != FLOG_FILTER_LEVEL_NONE)
+            {
+                pass = !(flog.level_fmt[level] & FLOG_FMT_TAG) ||
+                       node->level == FLOG_LEVEL_UNVALID || node->wildcard_level == FLOG_LEVEL_UNVALID ||
+                       (node->level != FLOG_FILTER_LEVEL_NONE && node->level <= level) ||
+                       (node->wildcard_level != FLOG_FILTER_LEVEL_NONE && node->wildcard_level <= level);
+            }
+        }
+        if (!pass)
+            continue;
+#endif // FLEXILOG_TAG_FILTER_NUM > 0
+#if defined(FLEXILOG_USE_SINK) && !defined(FLEXILOG_USE_ALL_LOG_RING_BUFFER)
+        /* 没有输出器接收的等级不需要格式化 */
+        if (flog.sink_route[level] == 0)
+            continue;
+#endif // FLEXILOG_USE_SINK && !FLEXILOG_USE_ALL_LOG_RING_BUFFER
+        mask |= 1U << level;
+    }
+    flog_level_mask = mask;
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+    flog_filter_generation = (flog_filter_generation + 1) & 0x00FFFFFF;
+    if (flog_filter_generation == 0)
+        flog_filter_generation = 1;
+#endif // FLEXILOG_TAG_FILTER_NUM > 0
+}
+
+#if defined(FLEXILOG_USE_RING_BUFFER) && !defined(FLEXILOG_AUTO_MALLOC)
+/**
+ * @brief 静态初始化
+ * @param parameter 静态初始化参数
+ */
+void flog_init(FLOG_RingBuffer_Init_Paremeter *parameter)
+#else
+/**
+ * @brief 初始化
+ */
+void flog_init(void)
+#endif
+{
+    flog_port_init();
+    flog.font_color[FLOG_LEVEL_DEBUG] = FLOG_COLOR_LIGHT_WHITE;
+    flog.font_color[FLOG_LEVEL_INFO] = FLOG_COLOR_GREEN;
+    flog.font_color[FLOG_LEVEL_WARN] = FLOG_COLOR_YELLOW;
+    flog.font_color[FLOG_LEVEL_ERROR] = FLOG_COLOR_RED;
+    flog.font_color[FLOG_LEVEL_RECORD] = FLOG_COLOR_PURPLE;
+    flog.font_color[FLOG_LEVEL_ASSERT] = FLOG_COLOR_WHITE;
+    flog.bg_color[FLOG_LEVEL_DEBUG] = FLOG_COLOR_UNVALID;
+    flog.bg_color[FLOG_LEVEL_INFO] = FLOG_COLOR_UNVALID;
+    flog.bg_color[FLOG_LEVEL_WARN] = FLOG_COLOR_UNVALID;
+    flog.bg_color[FLOG_LEVEL_ERROR] = FLOG_COLOR_UNVALID;
+    flog.bg_color[FLOG_LEVEL_RECORD] = FLOG_COLOR_UNVALID;
+    flog.bg_color[FLOG_LEVEL_ASSERT] = FLOG_COLOR_UNVALID;
+
+    flog.level_fmt[FLOG_LEVEL_DEBUG] = FLOG_FMT_DEFAULT;
+    flog.level_fmt[FLOG_LEVEL_INFO] = FLOG_FMT_DEFAULT;
+    flog.level_fmt[FLOG_LEVEL_WARN] = FLOG_FMT_DEFAULT;
+    flog.level_fmt[FLOG_LEVEL_ERROR] = FLOG_FMT_DEFAULT;
+    flog.level_fmt[FLOG_LEVEL_RECORD] = FLOG_FMT_DEFAULT | FLOG_FMT_THREAD | FLOG_FMT_FUNC;
+    flog.level_fmt[FLOG_LEVEL_ASSERT] = FLOG_FMT_DEFAULT | FLOG_FMT_THREAD | FLOG_FMT_FUNC;
+
+    flog.global_filter_level = FLOG_LEVEL_INFO;
+    flog.hardware_output_enable = true;
+    flog.output_lock_enbale = true;
+    flog.output_color_enable = true;
+    for (int level = 0; level < FLOG_LEVEL_UNVALID; ++level)
+    {
+        flog.level_pattern[level] = NULL;
+        flog_prefix_compile(&flog.prefix[level], (FLOG_LEVEL)level, flog.level_fmt[level], NULL);
+    }
+
+#ifdef FLEXILOG_USE_SINK
+    memset(flog.sinks, 0, sizeof(flog.sinks));
+    flog.sinks[FLOG_SINK_PORT].output = flog_sink_port_output;
+    flog.sinks[FLOG_SINK_PORT].enable = true;
+    flog.sinks[FLOG_SINK_PORT].level = FLOG_LEVEL_DEBUG;
+    flog.sinks[FLOG_SINK_PORT].fmt = FLOG_FMT_ALL;
+    flog.sinks[FLOG_SINK_PORT].tag_mask = FLOG_SINK_TAG_ALL;
+    flog_sink_update();
+#endif // FLEXILOG_USE_SINK
+
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+    flog_rb_init(&flog.async.queue, flog.async.queue_buffer, sizeof(flog.async.queue_buffer));
+    flog.async.busy = false;
+    flog.async.policy = FLOG_ASYNC_DROP_OLDEST;
+    flog_async_set_policy(FLEXILOG_ASYNC_OVERFLOW_POLICY);
+    flog.async.drop_count = 0;
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+    memset(&flog.batch.stats, 0, sizeof(flog.batch.stats));
+    flog.batch.size = 0;
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    flog.batch.fill = 0;
+    flog.batch.busy = false;
+    flog.batch.pending = NULL;
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+    memset(flog.tags, 0, sizeof(flog.tags));
+    memset(flog.tag_index, 0, sizeof(flog.tag_index));
+    flog.tag_num = 0;
+    flog_filter_init(&flog.tag_rules);
+#endif // FLEXILOG_TAG_FILTER_NUM > 0
+
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+    memset(&flog.ring_buffer_all, 0, sizeof(flog_log_rb_t));
+    #ifdef FLEXILOG_AUTO_MALLOC
+    flog_log_rb_buffer_create(&flog.ring_buffer_all, FLEXILOG_ALL_RING_BUFFER_SIZE);
+    #else
+    flexlog_assert(parameter->all_log_buffer != NULL);
+    flog_log_rb_init(&flog.ring_buffer_all, parameter->all_log_buffer, parameter->all_buffer_size);
+    #endif
+#endif  // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    flog_rb_view_init(&flog.view_all, FLOG_TARGET_ALL, FLOG_RB_VIEW_ANY_LEVEL);
+#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+    flog_rb_view_init(&flog.view_output, FLOG_TARGET_OUTPUT, FLOG_RB_VIEW_ANY_LEVEL);
+#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+    flog_rb_view_init(&flog.view_recod, FLOG_TARGET_RECOD, FLOG_RB_VIEW_ANY_LEVEL);
+    flog.recod_level = FLOG_LEVEL_RECORD;
+#endif // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+    {
+        flog.event_ring_buffer[i].event = i;
+        flog_rb_view_init(&flog.event_ring_buffer[i].view, FLOG_TARGET_EVENT, i);
+    }
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+#else
+#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+    memset(&flog.ring_buffer_output, 0, sizeof(flog_log_rb_t));
+    #ifdef FLEXILOG_AUTO_MALLOC
+    flog_log_rb_buffer_create(&flog.ring_buffer_output, FLEXILOG_OUTPUT_RING_BUFFER_SIZE);
+    #else
+    flexlog_assert(parameter->output_log_buffer != NULL);
+    flog_log_rb_init(&flog.ring_buffer_output, parameter->output_log_buffer, parameter->output_buffer_size);
+    #endif
+#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+
+#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+    memset(&flog.ring_buffer_recod, 0, sizeof(flog_log_rb_t));
+    flog.recod_level = FLOG_LEVEL_RECORD;
+    #ifdef FLEXILOG_AUTO_MALLOC
+    flog_log_rb_buffer_create(&flog.ring_buffer_recod, FLEXILOG_RECOD_RING_BUFFER_SIZE);
+    #else
+    flexlog_assert(parameter->recod_log_buffer != NULL);
+    flog_log_rb_init(&flog.ring_buffer_recod, parameter->recod_log_buffer, parameter->recod_buffer_size);
+    #endif
+#endif // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+    {
+        flog.event_ring_buffer[i].event = i;
+        #ifdef FLEXILOG_AUTO_MALLOC
+        flog_log_rb_buffer_create(&flog.event_ring_buffer[i].ring_bufer, FLEXILOG_EVENT_RING_BUFFER_SIZE / FLOG_EVENT_NUM);
+        #else
+        flexlog_assert(parameter->event_log_buffer != NULL);
+        uint32_t offset = i * parameter->event_buffer_size / FLOG_EVENT_NUM;
+        flog_log_rb_init(&flog.event_ring_buffer[i].ring_bufer, parameter->event_log_buffer + offset, parameter->event_buffer_size / FLOG_EVENT_NUM);
+        #endif
+    }
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+    flog_update_filter();
+    flog_printf(false, "Flexi Log init ok, version: %s\r\n", FLOG_VERSION);
+}
+
+
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+#ifndef FLEXILOG_AUTO_MALLOC
+void flog_set_ringbuffer_all(char *buffer, uint32_t size)
+{
+    flog_log_rb_init(&flog.ring_buffer_all, buffer, size);
+    flog_update_filter();
+}
+#endif // FLEXILOG_AUTO_MALLOC
+/**
+ * @brief 读取所有日志
+ * @param data 输出缓冲区
+ * @param size 缓冲区长度
+ * @return 读取长度
+ */
+uint32_t flog_read_all(char *data, uint32_t size)
+{
+    uint32_t read_size = 0;
+    FLOG_READ_LOCK();
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    read_size = flog_rb_read_view(&flog.ring_buffer_all, &flog.view_all, data, size, FLOG_RECORD_RENDER);
+#else
+    read_size = flog_log_rb_read_lines(&flog.ring_buffer_all, data, size);
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+    FLOG_READ_UNLOCK();
+    return read_size;
+}
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+#if !defined(FLEXILOG_AUTO_MALLOC) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
+void flog_set_ringbuffer_output(char *buffer, uint32_t size)
+{
+    flog_log_rb_init(&flog.ring_buffer_output, buffer, size);
+}
+#endif // !FLEXILOG_AUTO_MALLOC && !FLEXILOG_USE_SHARED_RING_BUFFER
+/**
+ * @brief 读取输出日志
+ * @param data 输出缓冲区
+ * @param size 缓冲区长度
+ * @return 读取长度
+ */
+uint32_t flog_read_output(char *data, uint32_t size)
+{
+    uint32_t read_size = 0;
+    FLOG_READ_LOCK();
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    read_size = flog_rb_read_view(&flog.ring_buffer_all, &flog.view_output, data, size, FLOG_RECORD_RENDER);
+#else
+    read_size = flog_log_rb_read_lines(&flog.ring_buffer_output, data, size);
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+    FLOG_READ_UNLOCK();
+    return read_size;
+}
+#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+
+#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+#if !defined(FLEXILOG_AUTO_MALLOC) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
+void flog_set_ringbuffer_recod(char *buffer, uint32_t size)
+{
+    flog_log_rb_init(&flog.ring_buffer_recod, buffer, size);
+}
+#endif // !FLEXILOG_AUTO_MALLOC && !FLEXILOG_USE_SHARED_RING_BUFFER
+/**
+ * @brief 读取记录日志
+ * @param data 输出缓冲区
+ * @param size 缓冲区长度
+ * @return 读取长度
+ */
+uint32_t flog_read_record(char *data, uint32_t size)
+{
+    uint32_t read_size = 0;
+    FLOG_READ_LOCK();
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    read_size = flog_rb_read_view(&flog.ring_buffer_all, &flog.view_recod, data, size, FLOG_RECORD_RENDER);
+#else
+    read_size = flog_log_rb_read_lines(&flog.ring_buffer_recod, data, size);
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+    FLOG_READ_UNLOCK();
+    return read_size;
+}
+#endif  // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+#if !defined(FLEXILOG_AUTO_MALLOC) && !defined(FLEXILOG_USE_SHARED_RING_BUFFER)
+void flog_set_ringbuffer_event(char *buffer, uint32_t size)
+{
+    uint32_t offset = 0;
+    if (buffer)
+    {
+        for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+        {
+            offset = i * size / FLOG_EVENT_NUM;
+            flog.event_ring_buffer[i].event = i;
+            flog_log_rb_init(&flog.event_ring_buffer[i].ring_bufer, buffer + offset, size / FLOG_EVENT_NUM);
+        }
+    }
+}
+#endif // !FLEXILOG_AUTO_MALLOC && !FLEXILOG_USE_SHARED_RING_BUFFER
+/**
+ * @brief 读取事件日志
+ * @param event  事件
+ * @param data 输出缓冲区
+ * @param size 缓冲区长度
+ * @return 读取长度
+ */
+uint32_t flog_read_event(FLOG_EVENT event, char *data, uint32_t size)
+{
+    uint32_t read_size = 0;
+    FLOG_READ_LOCK();
+    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+    {
+        if (flog.event_ring_buffer[i].event == event)
+        {
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+            read_size = flog_rb_read_view(&flog.ring_buffer_all, &flog.event_ring_buffer[i].view, data, size, FLOG_RECORD_RENDER);
+#else
+            read_size = flog_log_rb_read_lines(&flog.event_ring_buffer[i].ring_bufer, data, size);
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+            break;
+        }
+    }
+    FLOG_READ_UNLOCK();
+    return read_size;
+}
+
+#ifndef FLEXILOG_USE_SHARED_RING_BUFFER
+/**
+ * @brief 写入事件日志
+ * @param event  事件
+ * @param data 日志
+ * @param size 日志长度
+ * @param sequence 日志序号
+ */
+static void flog_write_event_ring_buffer(FLOG_EVENT event, const char *data, uint32_t size, uint32_t sequence)
+{
+    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+    {
+        if (flog.event_ring_buffer[i].event == event)
+        {
+            flog_log_rb_write(&flog.event_ring_buffer[i].ring_bufer, data, size, FLOG_LEVEL_UNVALID, FLOG_TARGET_EVENT, sequence);
+        }
+    }
+}
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+/**
+ * @brief 获取环形缓冲区丢弃的日志数量
+ * @note  最旧的记录长时间未提交时写入者会放弃等待并丢弃新日志, 返回所有环形缓冲区的累计值
+ * @return 丢弃的日志数量
+ */
+uint32_t flog_ring_buffer_get_drop_count(void)
+{
+    uint32_t count = 0;
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+    count += flog_lfrb_get_drop_count(&flog.ring_buffer_all);
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+    count += flog_lfrb_get_drop_count(&flog.ring_buffer_output);
+#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+    count += flog_lfrb_get_drop_count(&flog.ring_buffer_recod);
+#endif // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+    for (int i = 0; i < FLOG_EVENT_NUM; ++i)
+    {
+        count += flog_lfrb_get_drop_count(&flog.event_ring_buffer[i].ring_bufer);
+    }
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+    return count;
+}
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+
+/**
+ * @brief 设置全局过滤等级
+ * @param level 过滤等级
+ */
+void flog_set_global_filter(FLOG_LEVEL level)
+{
+    flog.global_filter_level = level;
+    flog_update_filter();
+}
+
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+/**
+ * @brief 查找已注册的tag
+ * @param tag  tag
+ * @param slot 返回tag在哈希索引中的位置, 未找到时为可插入的空位, 可以为NULL
+ * @return tag编号, 未注册返回-1
+ */
+static int flog_find_tag(const char *tag, uint32_t *slot)
+{
+    uint32_t pos = flog_strhash(tag, FLEXILOG_TAG_MAX_LENGTH) % FLOG_TAG_INDEX_SIZE;
+    while (flog.tag_index[pos] != 0)
+    {
+        int id = flog.tag_index[pos] - 1;
+        if (strncmp(flog.tags[id].tag, tag, FLEXILOG_TAG_MAX_LENGTH) == 0)
+            return id;
+        pos = (pos + 1) % FLOG_TAG_INDEX_SIZE;
+    }
+    if (slot != NULL)
+        *slot = pos;
+    return -1;
+}
+
+/**
+ * @brief 插入tag
+ * @note  调用前需要加锁
+ * @param tag  tag
+ * @return tag编号, 已注册时返回原编号, tag表已满返回-1
+ */
+static int flog_insert_tag(const char *tag)
+{
+    uint32_t slot = 0;
+    int id = flog_find_tag(tag, &slot);
+    if (id >= 0 || flog.tag_num >= FLEXILOG_TAG_FILTER_NUM)
+        return id;
+
+    id = flog.tag_num;
+    strncpy(flog.tags[id].tag, tag, FLEXILOG_TAG_MAX_LENGTH);
+    flog.tags[id].tag[FLEXILOG_TAG_MAX_LENGTH] = '\0';
+    flog.tags[id].level = flog_filter_resolve(&flog.tag_rules, tag);
+    flog.tag_num++;
+    flog.tag_index[slot] = id + 1;
+    return id;
+}
+
+/**
+ * @brief 注册tag
+ * @note  tag按哈希查找, 查找耗时与已注册的tag数量无关, 超过FLEXILOG_TAG_MAX_LENGTH的部分不参与比较
+ * @note  注册时按规则计算一次生效等级并缓存, 规则改变后重新计算; 输出日志时未注册的tag会自动注册
+ * @param tag  tag
+ * @return tag编号, 已注册时返回原编号, tag表已满返回-1
+ */
+int flog_register_tag(const char *tag)
+{
+    int id = flog_find_tag(tag, NULL);
+    if (id >= 0)
+        return id;
+    FLOG_LOCK();
+    id = flog_insert_tag(tag);
+    FLOG_UNLOCK();
+    return id;
+}
+
+/**
+ * @brief 设置tag过滤规则
+ * @note  "net.tcp"作用于net.tcp及其下级, "net.*"只作用于net的下级, "*"作用于所有tag, 更深的规则优先
+ * @note  重复设置会覆盖之前的等级, 规则数量受FLEXILOG_TAG_RULE_NODE_NUM限制
+ * @param tag  tag规则
+ * @param level 过滤等级
+ * @return true  设置成功
+ * @return false 规则格式错误或规则节点已用完
+ */
+bool flog_set_tag_filter(const char *tag, FLOG_LEVEL level)
+{
+    bool ok = false;
+    FLOG_LOCK();
+    ok = flog_filter_set(&flog.tag_rules, tag, level);
+    if (ok)
+    {
+        for (int i = 0; i < flog.tag_num; ++i)
+        {
+            flog.tags[i].level = flog_filter_resolve(&flog.tag_rules, flog.tags[i].tag);
+        }
+    }
+    FLOG_UNLOCK();
+    flog_update_filter();
+    return ok;
+}
+
+/**
+ * @brief 删除tag过滤规则
+ * @note  删除后回收不再使用的规则节点
+ * @param tag  tag规则, 与设置时相同
+ * @return true  删除成功或规则不存在
+ * @return false 规则格式错误
+ */
+bool flog_clear_tag_filter(const char *tag)
+{
+    bool ok = false;
+    FLOG_LOCK();
+    ok = flog_filter_set(&flog.tag_rules, tag, FLOG_FILTER_LEVEL_NONE);
+    if (ok)
+    {
+        for (int i = 0; i < flog.tag_num; ++i)
+        {
+            flog.tags[i].level = flog_filter_resolve(&flog.tag_rules, flog.tags[i].tag);
+        }
+    }
+    FLOG_UNLOCK();
+    flog_update_filter();
+    return ok;
+}
+
+/**
+ * @brief 获取tag生效的过滤等级
+ * @param tag  tag
+ * @return 过滤等级, FLOG_FILTER_LEVEL_NONE表示使用全局过滤等级
+ */
+static uint8_t flog_get_tag_level(const char *tag)
+{
+    int id = flog_find_tag(tag, NULL);
+    if (id < 0)
+        id = flog_register_tag(tag);
+    if (id < 0)
+        return flog_filter_resolve(&flog.tag_rules, tag);
+    return flog.tags[id].level;
+}
+
+/**
+ * @brief 判断日志是否被过滤
+ * @param level 等级
+ * @param tag  tag
+ * @return true     被过滤, 不输出
+ * @return false    不被过滤
+ */
+static bool flog_is_filtered(FLOG_LEVEL level, const char *tag)
+{
+    uint8_t filter_level = flog_get_tag_level(tag);
+    if (filter_level != FLOG_FILTER_LEVEL_NONE)
+    {
+        if (flog.level_fmt[level] & FLOG_FMT_TAG)
+        {
+            if (filter_level != FLOG_LEVEL_UNVALID && filter_level > level)
+                return true;
+        }
+        return false;
+    }
+    return level < flog.global_filter_level;
+}
+
+/**
+ * @brief 更新调用处的tag缓存
+ * @note  缓存高24位为过滤配置版本号, 低8位为该tag能输出的等级掩码
+ * @param tag   tag
+ * @param cache 调用处的缓存
+ * @return 新的缓存值
+ */
+uint32_t flog_update_tag_cache(const char *tag, uint32_t *cache)
+{
+    uint32_t generation = flog_filter_generation;
+    uint8_t mask = 0;
+    for (int level = 0; level < FLOG_LEVEL_UNVALID; ++level)
+    {
+        if ((flog_level_mask & (1U << level)) && !flog_is_filtered((FLOG_LEVEL)level, tag))
+        {
+            mask |= 1U << level;
+        }
+    }
+    *cache = (generation << 8) | mask;
+    return *cache;
+}
+#endif // (FLEXILOG_TAG_FILTER_NUM > 0)
+
+
+/**
+ * @brief 设置等级格式
+ * @note  使用自定义格式时颜色会占用静态部分的长度, 超出长度时保留原来的格式
+ * @param level 等级
+ * @param fmt 格式
+ * @return true 成功 false 前缀超出长度
+ */
+bool flog_set_level_fmt(FLOG_LEVEL level, uint16_t fmt)
+{
+    if (!flog_prefix_update(level, fmt, flog.level_pattern[level]))
+        return false;
+    flog_update_filter();
+    return true;
+}
+
+/**
+ * @brief 启用格式
+ * @note  可以通过或运算传入多个格式, 格式参考@ref FLOG_FMT
+ * @param level 等级
+ * @param fmt 需要启用的格式
+ * @return true 成功 false 前缀超出长度
+ */
+bool flog_enable_fmt(FLOG_LEVEL level, uint16_t fmt)
+{
+    return flog_set_level_fmt(level, fmt | flog.level_fmt[level]);
+}
+
+/**
+ * @brief 禁用格式
+ * @note  可以通过或运算传入多个格式, 格式参考@ref FLOG_FMT
+ * @param level 等级
+ * @param fmt 需要禁用的格式
+ * @return true 成功 false 前缀超出长度
+ */
+bool flog_disable_fmt(FLOG_LEVEL level, uint16_t fmt)
+{
+    return flog_set_level_fmt(level, flog.level_fmt[level] & (~fmt));
+}
+
+/**
+ * @brief 设置等级的自定义格式
+ * @note  %T时间 %L等级 %t标签 %F文件 %l行号 %f函数 %h线程 %m正文 %%百分号, 例如"%T %L %t %F:%l %m"
+ * @note  格式只在设置时解析一次, 输出时与默认格式开销相同; 颜色仍由FLOG_FMT_FONT_COLOR/FLOG_FMT_BG_COLOR决定
+ * @param level 等级
+ * @param pattern 自定义格式, 需要一直有效(通常为常量字符串), NULL恢复默认格式
+ * @return true 成功 false 格式错误或过长
+ */
+bool flog_set_level_pattern(FLOG_LEVEL level, const char *pattern)
+{
+    return flog_prefix_update(level, flog.level_fmt[level], pattern);
+}
+
+/**
+ * @brief 设置字体颜色
+ * @param level 等级
+ * @param color 颜色
+ * @return true 成功 false 前缀超出长度, 保留原来的颜色
+ */
+bool flog_set_font_color(FLOG_LEVEL level, FLOG_COLOR color)
+{
+    FLOG_COLOR old_color = flog.font_color[level];
+    flog.font_color[level] = color;
+    if (flog_enable_fmt(level, FLOG_FMT_FONT_COLOR))
+        return true;
+    /* 输出器的前缀已按新颜色编译, 恢复后重新编译 */
+    flog.font_color[level] = old_color;
+    flog_prefix_update(level, flog.level_fmt[level], flog.level_pattern[level]);
+    return false;
+}
+
+/**
+ * @brief 设置背景颜色
+ * @param level 等级
+ * @param color 颜色
+ * @return true 成功 false 前缀超出长度, 保留原来的颜色
+ */
+bool flog_set_bg_color(FLOG_LEVEL level, FLOG_COLOR color)
+{
+    FLOG_COLOR old_color = flog.bg_color[level];
+    flog.bg_color[level] = color;
+    if (flog_enable_fmt(level, FLOG_FMT_BG_COLOR))
+        return true;
+    /* 输出器的前缀已按新颜色编译, 恢复后重新编译 */
+    flog.bg_color[level] = old_color;
+    flog_prefix_update(level, flog.level_fmt[level], flog.level_pattern[level]);
+    return false;
+}
+
+/**
+ * @brief 硬件输出使能
+ * @param enable  是否使能
+ */
+void flog_hardware_output_enable(bool enable)
+{
+    flog.hardware_output_enable = enable;
+    flog_update_filter();
+}
+
+/**
+ * @brief 锁使能
+ * @param enable  是否使能
+ */
+void flog_lock_enable(bool enable)
+{
+    flog.output_lock_enbale = enable;
+}
+
+#ifdef FLEXILOG_USE_SINK
+/**
+ * @brief 判断输出器编号是否有效
+ * @param sink 输出器编号
+ * @return true 已注册 false 编号无效或未注册
+ */
+static bool flog_sink_valid(int sink)
+{
+    return sink >= 0 && sink < FLEXILOG_SINK_NUM && flog.sinks[sink].output != NULL;
+}
+
+/**
+ * @brief 注册输出器
+ * @note  注册后输出所有tag, 格式与等级格式相同; 0号输出器在初始化时注册为flog_port_output()
+ * @note  例如控制台只输出ERROR以上, 文件输出全部, 持久存储只输出RECORD以上, 分别注册三个输出器
+ * @param output 输出函数, 在日志锁内调用
+ * @param level 最低输出等级
+ * @return 输出器编号, 输出器已满返回-1
+ */
+int flog_sink_register(flog_sink_output_t output, FLOG_LEVEL level)
+{
+    int id = -1;
+    flexlog_assert(output != NULL);
+    FLOG_LOCK();
+    for (int i = 0; i < FLEXILOG_SINK_NUM; ++i)
+    {
+        if (flog.sinks[i].output == NULL)
+        {
+            id = i;
+            break;
+        }
+    }
+    if (id >= 0)
+    {
+        flog.sinks[id].output = output;
+        flog.sinks[id].enable = true;
+        flog.sinks[id].level = level;
+        flog.sinks[id].fmt = FLOG_FMT_ALL;
+        flog.sinks[id].pattern = NULL;
+        flog.sinks[id].tag_mask = FLOG_SINK_TAG_ALL;
+        flog_sink_update();
+    }
+    FLOG_UNLOCK();
+    flog_update_filter();
+    return id;
+}
+
+/**
+ * @brief 注销输出器
+ * @note  也可以注销0号输出器, 之后的日志不再调用flog_port_output()
+ * @param sink 输出器编号
+ */
+void flog_sink_unregister(int sink)
+{
+    FLOG_LOCK();
+    if (flog_sink_valid(sink))
+    {
+        flog.sinks[sink].output = NULL;
+        flog_sink_update();
+    }
+    FLOG_UNLOCK();
+    flog_update_filter();
+}
+
+/**
+ * @brief 输出器使能
+ * @param sink 输出器编号
+ * @param enable 是否使能
+ */
+void flog_sink_enable(int sink, bool enable)
+{
+    FLOG_LOCK();
+    if (flog_sink_valid(sink))
+    {
+        flog.sinks[sink].enable = enable;
+        flog_sink_update();
+    }
+    FLOG_UNLOCK();
+    flog_update_filter();
+}
+
+/**
+ * @brief 设置输出器的最低输出等级
+ * @note  全局过滤和tag过滤先于输出器生效, 输出器只能进一步过滤
+ * @param sink 输出器编号
+ * @param level 最低输出等级
+ */
+void flog_sink_set_level(int sink, FLOG_LEVEL level)
+{
+    FLOG_LOCK();
+    if (flog_sink_valid(sink))
+    {
+        flog.sinks[sink].level = level;
+        flog_sink_update();
+    }
+    FLOG_UNLOCK();
+    flog_update_filter();
+}
+
+/**
+ * @brief 设置输出器的tag掩码
+ * @note  需要启用tag过滤, 例如FLOG_SINK_TAG(flog_register_tag("net")) | FLOG_SINK_TAG(flog_register_tag("app"))
+ * @param sink 输出器编号
+ * @param mask tag掩码, FLOG_SINK_TAG_ALL表示输出所有tag
+ */
+void flog_sink_set_tag_mask(int sink, uint32_t mask)
+{
+    FLOG_LOCK();
+    if (flog_sink_valid(sink))
+    {
+        flog.sinks[sink].tag_mask = mask;
+    }
+    FLOG_UNLOCK();
+}
+
+/**
+ * @brief 设置输出器的格式
+ * @note  与每个等级的格式按位与后使用, 例如文件输出器去掉颜色: FLOG_FMT_ALL & ~(FLOG_FMT_FONT_COLOR | FLOG_FMT_BG_COLOR)
+ * @note  格式不同时在设置时编译前缀, 输出时按输出器的前缀重新拼接, 正文只格式化一次
+ * @param sink 输出器编号
+ * @param fmt 保留的格式 @ref FLOG_FMT, FLOG_FMT_ALL表示与等级格式相同
+ */
+void flog_sink_set_fmt(int sink, uint16_t fmt)
+{
+    FLOG_LOCK();
+    if (flog_sink_valid(sink))
+    {
+        flog.sinks[sink].fmt = fmt;
+        flog_sink_update();
+    }
+    FLOG_UNLOCK();
+}
+
+/**
+ * @brief 设置输出器的自定义格式
+ * @note  格式与flog_set_level_pattern()相同, 所有等级使用同一个格式, 例如文件输出器使用"%T %L %t %m"
+ * @note  在设置时为每个等级编译前缀, 输出时按输出器的前缀重新拼接, 正文只格式化一次
+ * @param sink 输出器编号
+ * @param pattern 自定义格式, 需要一直有效(通常为常量字符串), NULL表示使用等级的自定义格式
+ * @return true 成功 false 输出器无效, 格式错误或过长, 失败时保留原来的格式
+ */
+bool flog_sink_set_pattern(int sink, const char *pattern)
+{
+    bool ok = false;
+    FLOG_LOCK();
+    if (flog_sink_valid(sink))
+    {
+        const char *old_pattern = flog.sinks[sink].pattern;
+        ok = true;
+        flog.sinks[sink].pattern = pattern;
+        for (int level = 0; level < FLOG_LEVEL_UNVALID; ++level)
+        {
+            ok = flog_sink_compile((FLOG_LEVEL)level) && ok;
+        }
+        if (!ok)
+        {
+            flog.sinks[sink].pattern = old_pattern;
+            flog_sink_update();
+        }
+    }
+    FLOG_UNLOCK();
+    return ok;
+}
+#endif // FLEXILOG_USE_SINK
+
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+/**
+ * @brief 写入异步队列
+ * @note  需要在加锁状态下调用, FLOG_ASYNC_BLOCK策略等待时会临时释放锁
+ * @param buf 日志
+ * @param size 日志长度
+ */
+static void flog_async_enqueue(const char *buf, uint32_t size)
+{
+    uint32_t used_size = 0;
+    if (size > flog.async.queue.size)
+    {
+        size = flog.async.queue.size;
+    }
+    if (flog_rb_get_free(&flog.async.queue) < size)
+    {
+        switch (flog.async.policy)
+        {
+            case FLOG_ASYNC_BLOCK:
+                while (flog_rb_get_free(&flog.async.queue) < size)
+                {
+                    FLOG_UNLOCK();
+                    flog_port_async_notify();
+                    flog_port_async_wait();
+                    FLOG_LOCK();
+                }
+                break;
+            case FLOG_ASYNC_DROP_NEWEST:
+                flog.async.drop_count += size;
+                return;
+            case FLOG_ASYNC_DROP_OLDEST:
+            default:
+                used_size = flog_rb_get_used(&flog.async.queue);
+                flog_rb_drop_lines(&flog.async.queue, size - flog_rb_get_free(&flog.async.queue));
+                flog.async.drop_count += used_size - flog_rb_get_used(&flog.async.queue);
+                break;
+        }
+    }
+    flog_rb_write_force(&flog.async.queue, buf, size);
+    flog_port_async_notify();
+}
+
+/**
+ * @brief 处理异步队列
+ * @note  由后台输出任务循环调用, 将队列中的日志分批输出到硬件, 输出时不持有锁
+ * @note  只能有一个后台任务调用
+ * @return 本次输出的字节数
+ */
+uint32_t flog_async_process(void)
+{
+    uint32_t total_size = 0;
+    uint32_t read_size = 0;
+    while (1)
+    {
+        FLOG_LOCK();
+        read_size = flog_rb_read(&flog.async.queue, flog.async.batch_buffer, sizeof(flog.async.batch_buffer));
+        flog.async.busy = (read_size > 0);
+        FLOG_UNLOCK();
+        if (read_size == 0)
+        {
+            break;
+        }
+        flog_port_output(flog.async.batch_buffer, read_size);
+        total_size += read_size;
+    }
+    return total_size;
+}
+
+/**
+ * @brief 设置异步队列溢出策略
+ * @note  FLOG_ASYNC_BLOCK等待时会释放锁, 需要启用FLEXILOG_USE_THREAD_CONTEXT, 否则共用的格式化缓冲区可能被其他线程改写, 未启用时拒绝设置
+ * @param policy 溢出策略
+ * @return true 设置成功 false 策略无效或不支持, 保持原策略
+ */
+bool flog_async_set_policy(FLOG_ASYNC_POLICY policy)
+{
+#ifndef FLEXILOG_USE_THREAD_CONTEXT
+    if (policy == FLOG_ASYNC_BLOCK)
+    {
+        return false;
+    }
+#endif // FLEXILOG_USE_THREAD_CONTEXT
+    if (policy > FLOG_ASYNC_DROP_OLDEST)
+    {
+        return false;
+    }
+    flog.async.policy = policy;
+    return true;
+}
+
+/**
+ * @brief 获取异步队列丢弃的日志字节数
+ * @return 丢弃的字节数
+ */
+uint32_t flog_async_get_drop_count(void)
+{
+    return flog.async.drop_count;
+}
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+#define FLOG_BATCH_DEADLINE_TICKS ((uint64_t)FLEXILOG_BATCH_DEADLINE_MS * FLEXILOG_TICKS_PER_SECOND / 1000)
+
+/**
+ * @brief 获取正在填充的缓冲区
+ * @return 缓冲区
+ */
+static inline char *flog_batch_buffer(void)
+{
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    return flog.batch.buffer[flog.batch.fill];
+#else
+    return flog.batch.buffer;
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+}
+
+/**
+ * @brief 启动一次硬件输出
+ * @note  需要在加锁状态下调用, 双缓冲时buf在flog_output_complete()之前不能改写
+ * @param buf 输出数据
+ * @param size 输出数据长度
+ */
+static void flog_batch_start(const char *buf, uint32_t size)
+{
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    /* 先置位, 完成回调可能在启动函数返回前执行 */
+    flog.batch.busy = true;
+    flog_port_output_async(buf, size);
+#else
+    flog_port_output(buf, size);
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    flog.batch.stats.write_count++;
+    flog.batch.stats.byte_count += size;
+}
+
+/**
+ * @brief 等待正在进行的输出完成
+ * @note  需要在加锁状态下调用, 同步输出时直接返回
+ */
+static void flog_batch_wait(void)
+{
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    if (!flog.batch.busy)
+    {
+        return;
+    }
+    flog.batch.stats.wait_count++;
+    while (flog.batch.busy)
+    {
+        flog_port_output_wait();
+    }
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+}
+
+/**
+ * @brief 输出暂存的日志
+ * @note  需要在加锁状态下调用, 双缓冲时另一块正在输出则记下输出条件, 完成后再输出
+ * @param count 触发原因对应的统计项, 没有暂存的日志时不计数
+ */
+static void flog_batch_flush(uint32_t *count)
+{
+    if (flog.batch.size == 0)
+    {
+        return;
+    }
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    if (flog.batch.busy)
+    {
+        if (flog.batch.pending == NULL)
+        {
+            flog.batch.pending = count;
+        }
+        return;
+    }
+    flog.batch.pending = NULL;
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    flog_batch_start(flog_batch_buffer(), flog.batch.size);
+    (*count)++;
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    flog.batch.fill ^= 1;
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    flog.batch.size = 0;
+}
+
+/**
+ * @brief 输出完成后启动被推迟的输出
+ * @note  需要在加锁状态下调用
+ */
+static void flog_batch_resume(void)
+{
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+    if (flog.batch.pending != NULL && !flog.batch.busy)
+    {
+        flog_batch_flush(flog.batch.pending);
+    }
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+}
+
+/**
+ * @brief 超过期限时输出暂存的日志
+ * @note  需要在加锁状态下调用
+ * @param now 当前tick
+ */
+static void flog_batch_check_deadline(uint64_t now)
+{
+#if (FLEXILOG_BATCH_DEADLINE_MS > 0)
+    /* tick回退时差值很大, 同样立即输出 */
+    if (flog.batch.size > 0 && now - flog.batch.start_ticks >= FLOG_BATCH_DEADLINE_TICKS)
+    {
+        flog_batch_flush(&flog.batch.stats.deadline_count);
+    }
+#else
+    (void)now;
+#endif // FLEXILOG_BATCH_DEADLINE_MS > 0
+}
+
+/**
+ * @brief 写入暂存缓冲区
+ * @note  需要在加锁状态下调用, 达到阈值或超过期限时输出
+ * @param buf 日志
+ * @param size 日志长度
+ */
+static void flog_batch_write(const char *buf, uint32_t size)
+{
+    uint64_t now = flog_port_get_ticks();
+    flog.batch.stats.line_count++;
+    flog_batch_resume();
+    if (flog.batch.size + size > FLEXILOG_BATCH_BUFFER_SIZE)
+    {
+        /* 双缓冲时两块都不可用, 等待另一块输出完成 */
+        flog_batch_wait();
+        flog_batch_flush(&flog.batch.stats.full_count);
+    }
+    if (size >= FLEXILOG_BATCH_BUFFER_SIZE)
+    {
+        /* buf返回后会被改写, 异步输出时等待完成 */
+        flog_batch_wait();
+        flog_batch_start(buf, size);
+        flog.batch.stats.full_count++;
+        flog_batch_wait();
+        return;
+    }
+    if (flog.batch.size == 0)
+    {
+        flog.batch.start_ticks = now;
+    }
+    memcpy(flog_batch_buffer() + flog.batch.size, buf, size);
+    flog.batch.size += size;
+    if (flog.batch.size >= FLEXILOG_BATCH_THRESHOLD)
+    {
+        flog_batch_flush(&flog.batch.stats.full_count);
+    }
+    else
+    {
+        flog_batch_check_deadline(now);
+    }
+}
+
+/**
+ * @brief 高等级日志提交后立即输出
+ * @note  需要在加锁状态下调用
+ * @param level 日志等级, 没有等级时为FLOG_LEVEL_UNVALID
+ */
+static void flog_batch_commit(uint8_t level)
+{
+    if (level >= FLEXILOG_BATCH_FLUSH_LEVEL && level < FLOG_LEVEL_UNVALID)
+    {
+        flog_batch_flush(&flog.batch.stats.level_count);
+    }
+}
+
+/**
+ * @brief 检查暂存日志的期限
+ * @note  由定时器或空闲任务周期调用, 没有新日志写入时也能按FLEXILOG_BATCH_DEADLINE_MS输出
+ * @note  双缓冲时同时启动输出完成前被推迟的输出
+ */
+void flog_batch_poll(void)
+{
+    FLOG_LOCK();
+    flog_batch_resume();
+    flog_batch_check_deadline(flog_port_get_ticks());
+    FLOG_UNLOCK();
+}
+
+#ifdef FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+/**
+ * @brief 输出完成回调
+ * @note  flog_port_output_async()启动的输出完成后由中断或完成线程调用, 不加锁
+ * @note  只释放缓冲区, 被推迟的输出在下次写入日志, flog_batch_poll()或flog_flush()时启动
+ * @note  需要尽快输出时通知任务调用flog_batch_poll(), 不能在回调中直接调用, 写日志的线程可能持有锁等待本次输出完成
+ */
+void flog_output_complete(void)
+{
+    flog.batch.busy = false;
+}
+#endif // FLEXILOG_USE_OUTPUT_DOUBLE_BUFFER
+
+/**
+ * @brief 获取合并输出统计
+ * @param stats 统计
+ */
+void flog_batch_get_stats(flog_batch_stats_t *stats)
+{
+    flexlog_assert(stats);
+    FLOG_LOCK();
+    *stats = flog.batch.stats;
+    FLOG_UNLOCK();
+}
+#else
+#define flog_batch_commit(level)
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+
+/**
+ * @brief 输出到硬件
+ * @note  需要在加锁状态下调用
+ * @param buf 日志
+ * @param size 日志长度
+ */
+static void flog_hardware_output(const char *buf, uint32_t size)
+{
+#if defined(FLEXILOG_USE_ASYNC_OUTPUT)
+    flog_async_enqueue(buf, size);
+#elif defined(FLEXILOG_USE_OUTPUT_BATCH)
+    flog_batch_write(buf, size);
+#else
+    flog_port_output(buf, size);
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+}
+
+#ifdef FLEXILOG_USE_SINK
+/**
+ * @brief 0号输出器的输出函数
+ * @note  启用异步输出时写入异步队列, 其他输出器直接调用
+ * @param buf 日志
+ * @param size 日志长度
+ */
+static void flog_sink_port_output(const char *buf, size_t size)
+{
+    flog_hardware_output(buf, (uint32_t)size);
+}
+#endif // FLEXILOG_USE_SINK
+
+/**
+ * @brief 提交到硬件输出
+ * @note  启用输出器时分发给所有使能的输出器, 没有等级的输出不按等级和tag过滤
+ */
+#ifdef FLEXILOG_USE_SINK
+#define flog_commit_output(buf, size)   flog_sink_output(buf, size, NULL)
+#else
+#define flog_commit_output(buf, size)   flog_hardware_output(buf, size)
+#endif // FLEXILOG_USE_SINK
+
+/**
+ * @brief 提交日志到环形缓冲区和硬件
+ * @note  使用无锁环形缓冲区时, 只有硬件输出需要加锁
+ * @param buf 日志
+ * @param size 日志长度
+ * @param level 日志等级, 没有等级时为FLOG_LEVEL_UNVALID
+ * @param target 提交目标 @ref FLOG_TARGET_ALL
+ * @param event 事件, 仅target包含FLOG_TARGET_EVENT时有效
+ */
+static void flog_commit(const char *buf, uint32_t size, uint8_t level, uint8_t target, int event)
+{
+#ifdef FLEXILOG_USE_RING_BUFFER
+    uint32_t sequence = 0;
+#endif // FLEXILOG_USE_RING_BUFFER
+#ifndef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+    FLOG_COMMIT_LOCK();
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+#ifdef FLEXILOG_USE_FRAMED_RING_BUFFER
+    sequence = flog.sequence++;
+#endif // FLEXILOG_USE_FRAMED_RING_BUFFER
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+    /* 只写入一次, 各视图按记录的掩码过滤; 事件日志没有等级, 等级字段保存事件编号 */
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+    if (target & FLOG_TARGET_RESERVED)
+        flog_rb_commit_record(&flog.ring_buffer_all, size, level, target & (uint8_t)~(FLOG_TARGET_HARDWARE | FLOG_TARGET_RESERVED), sequence);
+    else
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+    if (target & (FLOG_TARGET_ALL | FLOG_TARGET_OUTPUT | FLOG_TARGET_RECOD | FLOG_TARGET_EVENT))
+        flog_rb_write_record(&flog.ring_buffer_all, buf, size, (target & FLOG_TARGET_EVENT) ? (uint8_t)event : level,
+                             target & (uint8_t)~FLOG_TARGET_HARDWARE, sequence);
+#else
+#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+    if (target & FLOG_TARGET_RESERVED)
+        flog_log_rb_commit(&flog.ring_buffer_all, size, level, target & (uint8_t)~FLOG_TARGET_RESERVED, sequence);
+    else
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+    if (target & FLOG_TARGET_ALL)
+        flog_log_rb_write(&flog.ring_buffer_all, buf, size, level, target, sequence);
+#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+    if (target & FLOG_TARGET_OUTPUT)
+        flog_log_rb_write(&flog.ring_buffer_output, buf, size, level, target, sequence);
+#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+    if (target & FLOG_TARGET_RECOD)
+        flog_log_rb_write(&flog.ring_buffer_recod, buf, size, level, target, sequence);
+#endif // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+    if (target & FLOG_TARGET_EVENT)
+        flog_write_event_ring_buffer((FLOG_EVENT)event, buf, size, sequence);
+#else
+    (void)event;
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+    if (target & FLOG_TARGET_HARDWARE)
+    {
+        FLOG_COMMIT_LOCK();
+        flog_commit_output(buf, size);
+        flog_batch_commit(level);
+        FLOG_COMMIT_UNLOCK();
+    }
+#else
+    if (target & FLOG_TARGET_HARDWARE)
+    {
+        flog_commit_output(buf, size);
+        flog_batch_commit(level);
+    }
+    FLOG_COMMIT_UNLOCK();
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+}
+
+/**
+ * @brief 等待日志全部输出到硬件
+ * @note  异步输出时阻塞到队列清空并且后台任务输出完成, 合并输出时输出暂存的日志, 双缓冲时等待输出完成, 同步输出时直接返回
+ */
+void flog_flush(void)
+{
+#ifdef FLEXILOG_USE_OUTPUT_BATCH
+    FLOG_LOCK();
+    flog_batch_wait();
+    flog_batch_flush(&flog.batch.stats.flush_count);
+    flog_batch_wait();
+    FLOG_UNLOCK();
+#endif // FLEXILOG_USE_OUTPUT_BATCH
+#ifdef FLEXILOG_USE_ASYNC_OUTPUT
+    bool done = false;
+    while (1)
+    {
+        FLOG_LOCK();
+        done = (flog_rb_get_used(&flog.async.queue) == 0) && !flog.async.busy;
+        FLOG_UNLOCK();
+        if (done)
+        {
+            break;
+        }
+        flog_port_async_notify();
+        flog_port_async_wait();
+    }
+#endif // FLEXILOG_USE_ASYNC_OUTPUT
+}
+
+/**
+ * @brief 计算格式化实际写入的长度
+ * @param ret vsnprintf的返回值
+ * @param size 缓冲区大小
+ * @return 实际写入的长度
+ */
+static uint32_t flog_format_size(int ret, uint32_t size)
+{
+    if (ret < 0 || size == 0)
+    {
+        return 0;
+    }
+    return ((uint32_t)ret >= size) ? (size - 1) : (uint32_t)ret;
+}
+
+/**
+ * @brief printf
+ * @param write_ring_buffer  是否写入ring buffer
+ * @param fmt  格式
+ * @param ...  参数
+ */
+void flog_printf(bool write_ring_buffer, const char *fmt, ...)
+{
+    uint32_t output_size = 0;
+    char *line_buffer = NULL;
+    va_list args;
+    FLOG_FORMAT_LOCK();
+    line_buffer = flog_get_context()->line_buffer;
+    va_start(args, fmt);
+    output_size = flog_format_size(flog_vsnprintf(line_buffer, FLEXILOG_LINE_MAX_LENGTH, fmt, args), FLEXILOG_LINE_MAX_LENGTH);
+    va_end(args);
+    flog_commit(line_buffer, output_size, FLOG_LEVEL_UNVALID, write_ring_buffer ? (FLOG_TARGET_ALL | FLOG_TARGET_OUTPUT | FLOG_TARGET_HARDWARE) : FLOG_TARGET_HARDWARE, 0);
+    FLOG_FORMAT_UNLOCK();
+}
+
+/**
+ * @brief 前缀拷贝字符串字段
+ * @param dest 目标位置
+ * @param str 字符串
+ * @param max_size 最大长度
+ * @return 拷贝长度
+ */
+static uint32_t flog_prefix_copy(char *dest, const char *str, uint32_t max_size)
+{
+    uint32_t len = strlen(str);
+    if (len > max_size)
+        len = max_size;
+    memcpy(dest, str, len);
+    return len;
+}
+
+/**
+ * @brief 前缀写入行号
+ * @note  与"%d"写入6字节缓冲区一致, 最多保留5位
+ * @param dest 目标位置
+ * @param line 行号
+ * @param max_size 最大长度
+ * @return 写入长度
+ */
+static uint32_t flog_prefix_line(char *dest, uint32_t line, uint32_t max_size)
+{
+    char digits[10];
+    uint32_t size = flog_utoa(digits, line);
+    if (size > 5)
+        size = 5;
+    if (size > max_size)
+        size = max_size;
+    memcpy(dest, digits, size);
+    return size;
+}
+
+/**
+ * @brief 按编译后的前缀拼接日志前缀
+ * @param line_buffer 行缓冲区
+ * @param prefix 编译后的前缀
+ * @param time 时间, NULL表示当前时间
+ * @param tag  tag
+ * @param file 文件名
+ * @param func 函数名
+ * @param line 行号
+ * @param thread 线程, NULL表示当前线程
+ * @return 前缀长度
+ */
+static uint32_t flog_prefix_render(char *line_buffer, const flog_prefix_t *prefix, const char *time,
+                                   const char *tag, const char *file, const char *func, uint32_t line, const char *thread)
+{
+    const char *text = prefix->text;
+    uint32_t log_size = 0;
+    uint32_t text_len = 0;
+
+    for (int i = 0; i < prefix->step_num; ++i)
+    {
+        /* 静态文本和字段一样按行缓冲区剩余空间截断 */
+        text_len = prefix->steps[i].len;
+        if (text_len > FLEXILOG_LINE_MAX_LENGTH - log_size)
+            text_len = FLEXILOG_LINE_MAX_LENGTH - log_size;
+        memcpy(line_buffer + log_size, text, text_len);
+        log_size += text_len;
+        text += prefix->steps[i].len;
+        switch (prefix->steps[i].field)
+        {
+        case FLOG_PREFIX_FIELD_TIME:
+            log_size += flog_prefix_copy(line_buffer + log_size, time ? time : flog_get_time(), FLEXILOG_LINE_MAX_LENGTH - log_size);
+            break;
+        case FLOG_PREFIX_FIELD_TAG:
+            log_size += flog_prefix_copy(line_buffer + log_size, tag, FLEXILOG_LINE_MAX_LENGTH - log_size);
+            break;
+        case FLOG_PREFIX_FIELD_FILE:
+            log_size += flog_prefix_copy(line_buffer + log_size, file, FLEXILOG_LINE_MAX_LENGTH - log_size);
+            break;
+        case FLOG_PREFIX_FIELD_LINE:
+            log_size += flog_prefix_line(line_buffer + log_size, line, FLEXILOG_LINE_MAX_LENGTH - log_size);
+            break;
+        case FLOG_PREFIX_FIELD_FUNC:
+            log_size += flog_prefix_copy(line_buffer + log_size, func, FLEXILOG_LINE_MAX_LENGTH - log_size);
+            break;
+        case FLOG_PREFIX_FIELD_THREAD:
+#ifdef FLEXILOG_USE_THREAD_NAME_CACHE
+            if (thread == NULL)
             {
-                return flog.tag_filters[i].level;
+                /* 缓存的线程名长度已知, 只需一次拷贝 */
+                uint32_t thread_len = 0;
+                const char *thread_name = flog_get_thread(&thread_len);
+                if (thread_len > FLEXILOG_LINE_MAX_LENGTH - log_size)
+                    thread_len = FLEXILOG_LINE_MAX_LENGTH - log_size;
+                memcpy(line_buffer + log_size, thread_name, thread_len);
+                log_size += thread_len;
+                break;
             }
+#endif // FLEXILOG_USE_THREAD_NAME_CACHE
+            log_size += flog_prefix_copy(line_buffer + log_size, thread ? thread : flog_port_get_thread(), FLEXILOG_LINE_MAX_LENGTH - log_size);
+            break;
+        default:
+            break;
         }
     }
-    return FLOG_LEVEL_UNVALID;
+    return log_size;
 }
 
-#endif // (FLEXILOG_TAG_FILTER_NUM > 0)
-
 /**
- * @brief 设置等级格式
+ * @brief 格式化日志前缀
+ * @note  正文长度和结尾必须使用同一个前缀计算
+ * @param line_buffer 行缓冲区
+ * @param prefix 返回实际使用的前缀
+ * @param temp_prefix 格式与当前前缀不同时临时编译的前缀
  * @param level 等级
- * @param fmt 格式
+ * @param fmt 格式 @ref FLOG_FMT
+ * @param pattern 自定义格式, NULL表示默认格式
+ * @param time 时间, NULL表示当前时间
+ * @param tag  tag
+ * @param file 文件名
+ * @param func 函数名
+ * @param line 行号
+ * @param thread 线程, NULL表示当前线程
+ * @return 前缀长度
  */
-void flog_set_level_fmt(FLOG_LEVEL level, uint16_t fmt)
+static uint32_t flog_format_prefix(char *line_buffer, const flog_prefix_t **prefix, flog_prefix_t *temp_prefix, FLOG_LEVEL level,
+                                   uint16_t fmt, const char *pattern, const char *time,
+                                   const char *tag, const char *file, const char *func, uint32_t line, const char *thread)
 {
-    flog.level_fmt[level] = fmt;
+    *prefix = &flog.prefix[level];
+
+    /* 延迟格式化的记录可能使用旧的格式, 临时编译 */
+    if ((*prefix)->fmt != fmt || flog.level_pattern[level] != pattern || (*prefix)->step_num == 0)
+    {
+        flog_prefix_compile(temp_prefix, level, fmt, pattern);
+        *prefix = temp_prefix;
+    }
+    return flog_prefix_render(line_buffer, *prefix, time, tag, file, func, line, thread);
 }
 
 /**
- * @brief 启用格式
- * @note  可以通过或运算传入多个格式, 格式参考@ref FLOG_FMT
- * @param level 等级
- * @param fmt 需要启用的格式
+ * @brief 计算日志正文可用长度
+ * @param prefix 编译后的前缀
+ * @param log_size 前缀长度
+ * @return 正文缓冲区大小
  */
-void flog_enable_fmt(FLOG_LEVEL level, uint16_t fmt)
+static uint32_t flog_prefix_body_size(const flog_prefix_t *prefix, uint32_t log_size)
 {
-    flog_set_level_fmt(level, fmt | flog.level_fmt[level]);
+    uint32_t tail_size = FLOG_LINE_TAIL_LENGTH + prefix->tail_len;
+    if (log_size < FLEXILOG_LINE_MAX_LENGTH - tail_size)
+    {
+        return FLEXILOG_LINE_MAX_LENGTH - tail_size - log_size;
+    }
+    return 0;
 }
 
 /**
- * @brief 禁用格式
- * @note  可以通过或运算传入多个格式, 格式参考@ref FLOG_FMT
- * @param level 等级
- * @param fmt 需要禁用的格式
+ * @brief 格式化日志结尾
+ * @param line_buffer 行缓冲区
+ * @param log_size 当前长度
+ * @param prefix 格式化前缀时使用的前缀
+ * @return 日志总长度
  */
-void flog_disable_fmt(FLOG_LEVEL level, uint16_t fmt)
+static uint32_t flog_format_suffix(char *line_buffer, uint32_t log_size, const flog_prefix_t *prefix)
 {
-    flog_set_level_fmt(level, flog.level_fmt[level] & (~fmt));
+    /* 自定义格式中正文之后的部分 */
+    memcpy(line_buffer + log_size, prefix->text + prefix->text_len - prefix->tail_len, prefix->tail_len);
+    log_size += prefix->tail_len;
+
+    /* 重置颜色 */
+    if (flog.output_color_enable && (prefix->fmt & (FLOG_FMT_FONT_COLOR | FLOG_FMT_BG_COLOR)))
+    {
+        log_size += flog_strcat(line_buffer + log_size, FLOG_COLOR_REST, FLEXILOG_LINE_MAX_LENGTH);
+    }
+    log_size += flog_strcat(line_buffer + log_size, FLOG_NEW_LINE, FLEXILOG_LINE_MAX_LENGTH);
+    return log_size;
 }
 
+#ifdef FLEXILOG_USE_SINK
 /**
- * @brief 设置字体颜色
- * @param level 等级
- * @param color 颜色
+ * @brief 按输出器的前缀重新拼接日志
+ * @note  正文已经格式化, 只重新拼接前缀和结尾, 正文超出时截断
+ * @param sink_buffer 渲染缓冲区
+ * @param prefix 输出器的前缀
+ * @param line 日志字段
+ * @return 日志总长度
  */
-void flog_set_font_color(FLOG_LEVEL level, FLOG_COLOR color)
+static uint32_t flog_sink_render(char *sink_buffer, const flog_prefix_t *prefix, const flog_sink_line_t *line)
 {
-    flog_enable_fmt(level, FLOG_FMT_FONT_COLOR);
-    flog.font_color[level] = color;
+    uint32_t log_size = flog_prefix_render(sink_buffer, prefix, line->time, line->tag, line->file, line->func, line->line, NULL);
+    uint32_t body_size = flog_prefix_body_size(prefix, log_size);
+    /* 与vsnprintf一致, 正文最多body_size - 1字节 */
+    body_size = (body_size == 0) ? 0 : (line->body_size < body_size ? line->body_size : body_size - 1);
+    memcpy(sink_buffer + log_size, line->body, body_size);
+    log_size += body_size;
+    memcpy(sink_buffer + log_size, prefix->text + prefix->text_len - prefix->tail_len, prefix->tail_len);
+    log_size += prefix->tail_len;
+    if (flog.output_color_enable && (prefix->fmt & (FLOG_FMT_FONT_COLOR | FLOG_FMT_BG_COLOR)))
+    {
+        log_size += flog_strcat(sink_buffer + log_size, FLOG_COLOR_REST, FLEXILOG_LINE_MAX_LENGTH);
+    }
+    log_size += flog_strcat(sink_buffer + log_size, FLOG_NEW_LINE, FLEXILOG_LINE_MAX_LENGTH);
+    return log_size;
 }
 
 /**
- * @brief 设置背景颜色
- * @param level 等级
- * @param color 颜色
+ * @brief 获取tag对应的输出器掩码位
+ * @param tag tag
+ * @return 掩码位 @ref FLOG_SINK_TAG
  */
-void flog_set_bg_color(FLOG_LEVEL level, FLOG_COLOR color)
+static uint32_t flog_sink_tag_bit(const char *tag)
 {
-    flog_enable_fmt(level, FLOG_FMT_BG_COLOR);
-    flog.bg_color[level] = color;
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+    return FLOG_SINK_TAG(flog_find_tag(tag, NULL));
+#else
+    (void)tag;
+    return FLOG_SINK_TAG(-1);
+#endif // FLEXILOG_TAG_FILTER_NUM > 0
 }
 
 /**
- * @brief 硬件输出使能
- * @param enable  是否使能
+ * @brief 分发日志到输出器
+ * @note  需要在加锁状态下调用, 只遍历该等级路由掩码中的输出器
+ * @note  格式与等级格式不同的输出器在渲染缓冲区中重新拼接, 与上一次渲染的格式相同时直接复用
+ * @param buf 按等级格式格式化的日志
+ * @param size 日志长度
+ * @param line 日志字段, NULL表示没有等级的输出, 原样发给所有使能的输出器
  */
-void flog_hardware_output_enable(bool enable)
+static void flog_sink_output(const char *buf, uint32_t size, const flog_sink_line_t *line)
 {
-    flog.hardware_output_enable = enable;
+    uint32_t route = flog.sink_route[line ? line->level : FLOG_LEVEL_UNVALID];
+    uint32_t plan = line ? flog.sink_plan[line->level] : 0;
+    uint32_t tag_bit = 0;
+    const flog_prefix_t *rendered = NULL;
+    char *sink_buffer = NULL;
+    uint32_t sink_size = 0;
+    for (int i = 0; route != 0; ++i, route >>= 1)
+    {
+        const struct flog_sink_t *sink = &flog.sinks[i];
+        if (!(route & 1U))
+            continue;
+        if (line && sink->tag_mask != FLOG_SINK_TAG_ALL)
+        {
+            if (tag_bit == 0)
+                tag_bit = flog_sink_tag_bit(line->tag);
+            if (!(sink->tag_mask & tag_bit))
+                continue;
+        }
+        if (!(plan & (1U << i)))
+        {
+            sink->output(buf, size);
+            continue;
+        }
+        if (rendered == NULL || rendered->fmt != sink->prefix[line->level].fmt)
+        {
+            rendered = &sink->prefix[line->level];
+            if (sink_buffer == NULL)
+                sink_buffer = flog_get_context()->sink_buffer;
+            sink_size = flog_sink_render(sink_buffer, rendered, line);
+        }
+        sink->output(sink_buffer, sink_size);
+    }
 }
+#endif // FLEXILOG_USE_SINK
+
+#ifdef FLEXILOG_USE_DEFERRED_FORMAT
+/* 延迟格式化记录头, 之后依次是线程名(前缀包含线程时)和打包的参数 */
+typedef struct
+{
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+    uint64_t ticks;         /* tick, 读取时再渲染为时间 */
+#else
+    uint32_t timestamp;     /* 时间戳 */
+#endif // FLEXILOG_USE_NUMERIC_TIME
+    uint32_t line;          /* 行号 */
+    uint16_t fmt;           /* 写入时的格式 @ref FLOG_FMT */
+    uint16_t fields;        /* 写入时前缀用到的动态字段 */
+    const char *pattern;    /* 写入时的自定义格式 */
+    const char *tag;        /* tag, 必须是常量字符串 */
+    const char *file;       /* 文件名 */
+    const char *func;       /* 函数名 */
+    const char *format;     /* 格式, 必须是常量字符串 */
+}flog_defer_head_t;
 
 /**
- * @brief 锁使能
- * @param enable  是否使能
+ * @brief 以二进制记录保存日志, 不进行格式化
+ * @param level 等级
+ * @param tag  tag
+ * @param file 文件名
+ * @param func 函数名
+ * @param line 行号
+ * @param fmt  格式
+ * @param args 参数
+ * @return true 已保存
+ * @return false 参数无法打包, 需要按文本格式化
  */
-void flog_lock_enable(bool enable)
+static bool flog_defer_capture(FLOG_LEVEL level, const char *tag, const char *file, const char *func, uint32_t line,
+                               const char *fmt, va_list args)
 {
-    flog.output_lock_enbale = enable;
+    flog_defer_head_t head;
+    uint32_t record_size = sizeof(head);
+    uint32_t pack_size = 0;
+    char *record = NULL;
+    bool packed = false;
+    va_list args_copy;
+    FLOG_FORMAT_LOCK();
+    record = flog_get_context()->line_buffer;
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+    head.ticks = flog_port_get_ticks();
+#else
+    head.timestamp = flog_port_get_timestamp();
+#endif // FLEXILOG_USE_NUMERIC_TIME
+    head.line = line;
+    head.fmt = flog.level_fmt[level];
+    head.fields = flog.prefix[level].fields;
+    head.pattern = flog.level_pattern[level];
+    head.tag = tag;
+    head.file = file;
+    head.func = func;
+    head.format = fmt;
+    if (head.fields & (1U << FLOG_PREFIX_FIELD_THREAD))
+    {
+#ifdef FLEXILOG_USE_THREAD_NAME_CACHE
+        uint32_t thread_len = 0;
+        record_size += flog_defer_pack_string(record + record_size, FLEXILOG_LINE_MAX_LENGTH - record_size, flog_get_thread(&thread_len));
+#else
+        record_size += flog_defer_pack_string(record + record_size, FLEXILOG_LINE_MAX_LENGTH - record_size, flog_port_get_thread());
+#endif // FLEXILOG_USE_THREAD_NAME_CACHE
+    }
+    va_copy(args_copy, args);
+    packed = flog_defer_pack(record + record_size, FLEXILOG_LINE_MAX_LENGTH - record_size, fmt, args_copy, &pack_size);
+    va_end(args_copy);
+    if (packed)
+    {
+        memcpy(record, &head, sizeof(head));
+        flog_commit(record, record_size + pack_size, level, FLOG_TARGET_ALL | FLOG_RB_RECORD_BINARY, 0);
+    }
+    FLOG_FORMAT_UNLOCK();
+    return packed;
 }
 
 /**
- * @brief printf
- * @param write_ring_buffer  是否写入ring buffer
- * @param fmt  格式
- * @param ...  参数
+ * @brief 渲染二进制记录
+ * @note  在读取锁内调用, 使用读取者自己的格式化缓冲区
+ * @param head 记录头
+ * @param record 记录内容
+ * @param text 文本缓冲区
+ * @param size 文本缓冲区大小
+ * @return 完整文本的长度
  */
-void flog_printf(bool write_ring_buffer, const char *fmt, ...)
+static uint32_t flog_defer_render_record(const flog_rb_record_t *head, const char *record, char *text, uint32_t size)
 {
-    uint32_t output_size = 0;
-    va_list args;
-    va_start(args, fmt);
-    output_size = vsnprintf(flog.line_buffer, FLEXILOG_LINE_MAX_LENGTH, fmt, args);
-    va_end(args);
-    FLOG_LOCK();
-#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
-    if (write_ring_buffer)
-        flog_rb_write_force(&flog.ring_buffer_all, flog.line_buffer, output_size);
-#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    if (write_ring_buffer)
-        flog_rb_write_force(&flog.ring_buffer_output, flog.line_buffer, output_size);
-#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    flog_port_output(flog.line_buffer, output_size);
-    FLOG_UNLOCK();
+    flog_defer_head_t defer;
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+    const char *time_str = "";
+#else
+    char time_str[32] = {0};
+#endif // FLEXILOG_USE_NUMERIC_TIME
+    const char *thread = NULL;
+    const flog_prefix_t *prefix = NULL;
+    flog_prefix_t temp_prefix;
+    const char *args = record + sizeof(defer);
+    uint32_t args_size = 0;
+    uint32_t thread_size = 0;
+    uint32_t log_size = 0;
+    char *line_buffer = flog_get_context()->line_buffer;
+    if (head->length < sizeof(defer) || head->level >= FLOG_LEVEL_UNVALID)
+    {
+        return 0;
+    }
+    memcpy(&defer, record, sizeof(defer));
+    args_size = head->length - sizeof(defer);
+    if (defer.fields & (1U << FLOG_PREFIX_FIELD_THREAD))
+    {
+        thread = args;
+        while (thread_size < args_size && thread[thread_size])
+        {
+            thread_size++;
+        }
+        if (thread_size == args_size)
+        {
+            return 0;
+        }
+        args += thread_size + 1;
+        args_size -= thread_size + 1;
+    }
+    if (defer.fields & (1U << FLOG_PREFIX_FIELD_TIME))
+    {
+#ifdef FLEXILOG_USE_NUMERIC_TIME
+        time_str = flog_time_render(flog_get_context(), defer.ticks);
+#else
+        flog_port_format_timestamp(defer.timestamp, time_str, sizeof(time_str));
+#endif // FLEXILOG_USE_NUMERIC_TIME
+    }
+
+    log_size = flog_format_prefix(line_buffer, &prefix, &temp_prefix, (FLOG_LEVEL)head->level, defer.fmt, defer.pattern, time_str,
+                                  defer.tag, defer.file, defer.func, defer.line, thread);
+    log_size += flog_defer_render(line_buffer + log_size, flog_prefix_body_size(prefix, log_size), defer.format, args, args_size);
+    log_size = flog_format_suffix(line_buffer, log_size, prefix);
+    if (log_size < size)
+    {
+        memcpy(text, line_buffer, log_size);
+    }
+    return log_size;
 }
+#endif // FLEXILOG_USE_DEFERRED_FORMAT
 
 /**
  * @brief 输出日志
@@ -647,191 +2621,391 @@ void flog_output(FLOG_LEVEL level, const char *tag, const char *file, const char
         return;
 #endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
     uint32_t log_size = 0;
+    uint32_t body_size = 0;
+    uint32_t prefix_size = 0;
+    uint8_t target = 0;
+    char *line_buffer = NULL;
+    const char *time = NULL;
+    const flog_prefix_t *prefix = NULL;
+    flog_prefix_t temp_prefix;
 
     /* TAG过滤器 */
 #if (FLEXILOG_TAG_FILTER_NUM > 0)
-    if (flog_is_tag_in_filter(tag))
+    if (flog_is_filtered(level, tag))
+        return;
+#endif
+
+#ifdef FLEXILOG_USE_DEFERRED_FORMAT
+    /* 不输出到硬件的日志只保存参数, 读取时再格式化 */
+    if (!flog.hardware_output_enable)
     {
-        if (flog.level_fmt[level] & FLOG_FMT_TAG)
-        {
-            FLOG_LEVEL filter_level = flog_get_tag_filter_level(tag);
-            if (filter_level != FLOG_LEVEL_UNVALID && filter_level > level)
-                return;
-        }
+        va_list args;
+        bool captured = false;
+        va_start(args, fmt);
+        captured = flog_defer_capture(level, tag, file, func, line, fmt, args);
+        va_end(args);
+        if (captured)
+            return;
     }
-    else
+#endif // FLEXILOG_USE_DEFERRED_FORMAT
+
+    FLOG_FORMAT_LOCK();
+    line_buffer = flog_get_context()->line_buffer;
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+    /* 预留空间连续时直接格式化到全部环形缓冲区, 跨越缓冲区末尾时仍使用行缓冲区 */
+    flog_rb_span_t span[2];
+    flog_log_rb_reserve(&flog.ring_buffer_all, FLEXILOG_LINE_MAX_LENGTH, span);
+    if (span[0].size == FLEXILOG_LINE_MAX_LENGTH)
     {
-        if (level < flog.global_filter_level)
-            return;
+        line_buffer = span[0].data;
+        target = FLOG_TARGET_RESERVED;
     }
-#endif
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+#ifdef FLEXILOG_USE_SINK
+    /* 有输出器使用独立格式时, 各个格式使用同一个时间 */
+    if (flog.sink_plan[level] & flog.sink_route[level])
+        time = flog_get_time();
+#endif // FLEXILOG_USE_SINK
+    prefix_size = flog_format_prefix(line_buffer, &prefix, &temp_prefix, level, flog.level_fmt[level], flog.level_pattern[level],
+                                     time, tag, file, func, line, NULL);
 
-    /* 添加颜色 */
-    if (flog.output_color_enable && (flog.level_fmt[level] & (FLOG_FMT_FONT_COLOR | FLOG_FMT_BG_COLOR)))
+    /* 格式化日志 */
+    body_size = flog_prefix_body_size(prefix, prefix_size);
+    va_list args;
+    va_start(args, fmt);
+    body_size = flog_format_size(flog_vsnprintf(line_buffer + prefix_size, body_size, fmt, args), body_size);
+    va_end(args);
+    log_size = flog_format_suffix(line_buffer, prefix_size + body_size, prefix);
+
+    target |= FLOG_TARGET_ALL;
+    if (flog.hardware_output_enable)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, FLOG_COLOR_START, FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, flog_font_color_table[flog.font_color[level]], FLEXILOG_LINE_MAX_LENGTH);
-        if (flog.level_fmt[level] & FLOG_FMT_BG_COLOR && flog.bg_color[level] != FLOG_COLOR_UNVALID)
+        target |= FLOG_TARGET_OUTPUT | FLOG_TARGET_HARDWARE;
+#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
+        if (level >= flog.recod_level)
         {
-            log_size += flog_strcat(flog.line_buffer + log_size, FLOG_COLOR_ADD, FLEXILOG_LINE_MAX_LENGTH);
-            log_size += flog_strcat(flog.line_buffer + log_size, flog_bg_color_table[flog.bg_color[level]], FLEXILOG_LINE_MAX_LENGTH);
+            target |= FLOG_TARGET_RECOD;
         }
-        log_size += flog_strcat(flog.line_buffer + log_size, FLOG_COLOR_END, FLEXILOG_LINE_MAX_LENGTH);
+#endif  // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
     }
-
-    /* 添加时间 */
-    if (flog.level_fmt[level] & FLOG_FMT_TIME)
+#ifdef FLEXILOG_USE_SINK
+    /* 输出器需要日志字段来重新拼接, 不经过flog_commit的硬件输出 */
+    flog_commit(line_buffer, log_size, level, target & (uint8_t)~FLOG_TARGET_HARDWARE, 0);
+    if (target & FLOG_TARGET_HARDWARE)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, "[", FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, flog_port_get_time(), FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, "]", FLEXILOG_LINE_MAX_LENGTH);
+        flog_sink_line_t sink_line = {level, time, tag, file, func, line, line_buffer + prefix_size, body_size};
+        FLOG_COMMIT_LOCK();
+        flog_sink_output(line_buffer, log_size, &sink_line);
+        flog_batch_commit(level);
+        FLOG_COMMIT_UNLOCK();
     }
+#else
+    flog_commit(line_buffer, log_size, level, target, 0);
+#endif // FLEXILOG_USE_SINK
+    FLOG_FORMAT_UNLOCK();
+}
 
-    /* 添加等级 */
-    if (flog.level_fmt[level] & FLOG_FMT_LEVEL)
+#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+void flog_output_event(FLOG_EVENT event, const char *file, const char *func, uint32_t line, const char *fmt, ...)
+{
+    uint32_t log_size = 0;
+    uint32_t body_size = 0;
+    uint8_t target = 0;
+    char *line_buffer = NULL;
+    char temp_str[FLEXILOG_FILE_NAME_MAX_LENGTH + FLEXILOG_FUNCTION_NAME_MAX_LENGTH + 12];
+    char temp_number[12];
+    uint32_t temp_size = 0;
+    FLOG_FORMAT_LOCK();
+    line_buffer = flog_get_context()->line_buffer;
+    /* 时间 */
+    log_size += flog_strcat(line_buffer + log_size, "[", FLEXILOG_LINE_MAX_LENGTH);
+    log_size += flog_strcat(line_buffer + log_size, flog_get_time(), FLEXILOG_LINE_MAX_LENGTH);
+    log_size += flog_strcat(line_buffer + log_size, "]", FLEXILOG_LINE_MAX_LENGTH);
+
+    /* 事件 */
+    log_size += flog_strcat(line_buffer + log_size, "[", FLEXILOG_LINE_MAX_LENGTH);
+    log_size += flog_strcat(line_buffer + log_size, "event:", FLEXILOG_LINE_MAX_LENGTH);
+    temp_str[flog_itoa(temp_str, (int32_t)event)] = '\0';
+    log_size += flog_strcat(line_buffer + log_size, temp_str, FLEXILOG_LINE_MAX_LENGTH);
+    log_size += flog_strcat(line_buffer + log_size, "]", FLEXILOG_LINE_MAX_LENGTH);
+
+    /* 函数 */
+    temp_number[flog_itoa(temp_number, (int32_t)line)] = '\0';
+    temp_size = flog_strcat(temp_str, "(", sizeof(temp_str) - 1);
+    temp_size += flog_strcat(temp_str + temp_size, file, sizeof(temp_str) - 1 - temp_size);
+    temp_size += flog_strcat(temp_str + temp_size, ":", sizeof(temp_str) - 1 - temp_size);
+    temp_size += flog_strcat(temp_str + temp_size, temp_number, sizeof(temp_str) - 1 - temp_size);
+    temp_size += flog_strcat(temp_str + temp_size, ",", sizeof(temp_str) - 1 - temp_size);
+    temp_size += flog_strcat(temp_str + temp_size, func, sizeof(temp_str) - 1 - temp_size);
+    temp_size += flog_strcat(temp_str + temp_size, "()): ", sizeof(temp_str) - 1 - temp_size);
+    temp_str[temp_size] = '\0';
+    log_size += flog_strcat(line_buffer + log_size, temp_str, FLEXILOG_LINE_MAX_LENGTH);
+
+    /* 格式化日志 */
+    if (log_size < FLEXILOG_LINE_MAX_LENGTH - FLOG_LINE_TAIL_LENGTH)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, flog_level_str_table[level], FLEXILOG_LINE_MAX_LENGTH);
+        body_size = FLEXILOG_LINE_MAX_LENGTH - FLOG_LINE_TAIL_LENGTH - log_size;
     }
+    va_list args;
+    va_start(args, fmt);
+    log_size += flog_format_size(flog_vsnprintf(line_buffer + log_size, body_size, fmt, args), body_size);
+    va_end(args);
 
-    /* 添加标签 */
-    if (flog.level_fmt[level] & FLOG_FMT_TAG)
+    log_size += flog_strcat(line_buffer + log_size, FLOG_NEW_LINE, FLEXILOG_LINE_MAX_LENGTH);
+    target = FLOG_TARGET_EVENT | FLOG_TARGET_ALL;
+    if (flog.hardware_output_enable)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, "[", FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, tag, FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, "]", FLEXILOG_LINE_MAX_LENGTH);
+        target |= FLOG_TARGET_OUTPUT | FLOG_TARGET_HARDWARE;
     }
+    flog_commit(line_buffer, log_size, FLOG_LEVEL_UNVALID, target, event);
+    FLOG_FORMAT_UNLOCK();
+}
+#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
 
-    /* 添加括号 */
-    if (flog.level_fmt[level] & (FLOG_FMT_FILE | FLOG_FMT_FUNC | FLOG_FMT_LINE))
+
+/**
+ * @brief 十六进制查找表, 每个字节对应两个字符
+ */
+#define FLOG_HEX_DUMP_PAIR_ROW(h) #h "0" #h "1" #h "2" #h "3" #h "4" #h "5" #h "6" #h "7" \
+                                  #h "8" #h "9" #h "A" #h "B" #h "C" #h "D" #h "E" #h "F"
+static const char flog_hex_dump_pairs[] = FLOG_HEX_DUMP_PAIR_ROW(0) FLOG_HEX_DUMP_PAIR_ROW(1) FLOG_HEX_DUMP_PAIR_ROW(2) FLOG_HEX_DUMP_PAIR_ROW(3)
+                                          FLOG_HEX_DUMP_PAIR_ROW(4) FLOG_HEX_DUMP_PAIR_ROW(5) FLOG_HEX_DUMP_PAIR_ROW(6) FLOG_HEX_DUMP_PAIR_ROW(7)
+                                          FLOG_HEX_DUMP_PAIR_ROW(8) FLOG_HEX_DUMP_PAIR_ROW(9) FLOG_HEX_DUMP_PAIR_ROW(A) FLOG_HEX_DUMP_PAIR_ROW(B)
+                                          FLOG_HEX_DUMP_PAIR_ROW(C) FLOG_HEX_DUMP_PAIR_ROW(D) FLOG_HEX_DUMP_PAIR_ROW(E) FLOG_HEX_DUMP_PAIR_ROW(F);
+
+/**
+ * @brief 十六进制输出一行
+ * @note  按数据类型分组, 组内高字节在前, 不足16字节的部分用空格补齐
+ * @param dest 目标位置, 至少FLOG_HEX_DUMP_ROW_LENGTH + title_len + 1字节
+ * @param title 标题, 可以为NULL
+ * @param title_len 标题长度
+ * @param data 本行数据
+ * @param offset 本行地址
+ * @param count 本行字节数, 不超过16
+ * @param unit 每组字节数, 1, 2或4
+ * @return 写入长度
+ */
+static uint32_t flog_hex_dump_row(char *dest, const char *title, uint32_t title_len, const uint8_t *data,
+                                  uint32_t offset, uint32_t count, uint32_t unit)
+{
+    static const char digits[] = "0123456789ABCDEF";
+    uint32_t len = 0;
+    if (title)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, "(", FLEXILOG_LINE_MAX_LENGTH);
-        /* 添加文件 */
-        if (flog.level_fmt[level] & FLOG_FMT_FILE)
-            log_size += flog_strcat(flog.line_buffer + log_size, file, FLEXILOG_LINE_MAX_LENGTH);
+        memcpy(dest, title, title_len);
+        dest[title_len] = ' ';
+        len = title_len + 1;
     }
-
-    /* 添加行号 */
-    if (flog.level_fmt[level] & FLOG_FMT_LINE)
+    dest[len] = '0';
+    dest[len + 1] = 'x';
+    for (uint32_t i = 0; i < 8; ++i)
     {
-        char line_str[6] = {0};
-        log_size += flog_strcat(flog.line_buffer + log_size, ":", FLEXILOG_LINE_MAX_LENGTH);
-        snprintf(line_str, sizeof(line_str), "%d", line);
-        log_size += flog_strcat(flog.line_buffer + log_size, line_str, FLEXILOG_LINE_MAX_LENGTH);
+        dest[len + 9 - i] = digits[(offset >> (i * 4)) & 0x0F];
     }
+    dest[len + 10] = ' ';
+    len += 11;
 
-    /* 添加函数 */
-    if (flog.level_fmt[level] & FLOG_FMT_FUNC)
+    /* 整行数据不需要判断补齐 */
+    uint32_t full = count - count % unit;
+    for (uint32_t i = 0; i < full; i += unit)
     {
-        if (flog.level_fmt[level] & FLOG_FMT_LINE)
+        for (uint32_t j = unit; j > 0; --j)
         {
-            log_size += flog_strcat(flog.line_buffer + log_size, ",", FLEXILOG_LINE_MAX_LENGTH);
+            memcpy(dest + len, flog_hex_dump_pairs + data[i + j - 1] * 2, 2);
+            len += 2;
         }
-        log_size += flog_strcat(flog.line_buffer + log_size, func, FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, "()", FLEXILOG_LINE_MAX_LENGTH);
+        dest[len++] = ' ';
     }
-
-    /* 括号结尾 */
-    if (flog.level_fmt[level] & (FLOG_FMT_FILE | FLOG_FMT_FUNC | FLOG_FMT_LINE))
+    if (full < FLOG_HEX_DUMP_ROW_BYTES)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, ")", FLEXILOG_LINE_MAX_LENGTH);
+        uint32_t space = (FLOG_HEX_DUMP_ROW_BYTES - full) / unit * (unit * 2 + 1);
+        memset(dest + len, ' ', space);
+        len += space;
     }
-
-    /* 添加线程 */
-    if (flog.level_fmt[level] & FLOG_FMT_THREAD)
+    memset(dest + len, ' ', 4);
+    len += 4;
+    for (uint32_t i = 0; i < count; ++i)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, "(theard:", FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, flog_port_get_thread(), FLEXILOG_LINE_MAX_LENGTH);
-        log_size += flog_strcat(flog.line_buffer + log_size, ")", FLEXILOG_LINE_MAX_LENGTH);
+        /* 0x20~0x7E为可打印字符 */
+        dest[len + i] = ((uint8_t)(data[i] - 0x20) < 0x5F) ? (char)data[i] : '.';
     }
-    log_size += flog_strcat(flog.line_buffer + log_size, ": ", FLEXILOG_LINE_MAX_LENGTH);
-    /* 格式化日志 */
-    va_list args;
-    va_start(args, fmt);
-    log_size += vsnprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, fmt, args);
-    va_end(args);
-
-    /* 重置颜色 */
-    if (flog.output_color_enable && (flog.level_fmt[level] & (FLOG_FMT_FONT_COLOR | FLOG_FMT_BG_COLOR)))
+    if (count < FLOG_HEX_DUMP_ROW_BYTES)
     {
-        log_size += flog_strcat(flog.line_buffer + log_size, FLOG_COLOR_REST, FLEXILOG_LINE_MAX_LENGTH);
+        memset(dest + len + count, ' ', FLOG_HEX_DUMP_ROW_BYTES - count);
     }
+    len += FLOG_HEX_DUMP_ROW_BYTES;
+    dest[len++] = '\r';
+    dest[len++] = '\n';
+    return len;
+}
 
-    log_size += flog_strcat(flog.line_buffer + log_size, FLOG_NEW_LINE, FLEXILOG_LINE_MAX_LENGTH);
-    FLOG_LOCK();
-#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
-    flog_rb_write_force(&flog.ring_buffer_all, flog.line_buffer, log_size);
-    if (!flog.hardware_output_enable)
-        return;
-#endif  // FLEXILOG_USE_ALL_LOG_RING_BUFFER
-
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    flog_rb_write_force(&flog.ring_buffer_output, flog.line_buffer, log_size);
-#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-
-#ifdef FLEXILOG_USE_RECOD_LOG_RING_BUFFER
-    if (level >= flog.recod_level)
+/**
+ * @brief 计算十六进制输出的行长度
+ * @param title 标题, 可以为NULL
+ * @param title_len 返回截断后的标题长度
+ * @param unit 每组字节数
+ * @return 每行长度
+ */
+static uint32_t flog_hex_dump_row_size(const char *title, uint32_t *title_len, uint32_t unit)
+{
+    uint32_t row_size = 0;
+    if (title)
     {
-        flog_rb_write_force(&flog.ring_buffer_recod, flog.line_buffer, log_size);
+        if (*title_len > FLEXILOG_LINE_MAX_LENGTH - FLOG_HEX_DUMP_ROW_LENGTH - 1)
+        {
+            *title_len = FLEXILOG_LINE_MAX_LENGTH - FLOG_HEX_DUMP_ROW_LENGTH - 1;
+        }
+        row_size = *title_len + 1;
     }
-#endif  // FLEXILOG_USE_RECOD_LOG_RING_BUFFER
-
-    flog_port_output(flog.line_buffer, log_size);
-    FLOG_UNLOCK();
+    return row_size + 11 + (FLOG_HEX_DUMP_ROW_BYTES / unit) * (unit * 2 + 1) + 4 + FLOG_HEX_DUMP_ROW_BYTES + 2;
 }
 
-#ifdef FLEXILOG_USE_EVENT_LOG_RING_BUFFER
-void flog_output_event(FLOG_EVENT event, const char *file, const char *func, uint32_t line, const char *fmt, ...)
+#ifdef FLEXILOG_USE_BINARY_HEX_DUMP
+/* 十六进制输出记录头, 之后依次是标题和原始数据 */
+typedef struct
 {
-    uint32_t log_size = 0;
-    static char temp_str[FLEXILOG_FILE_NAME_MAX_LENGTH + FLEXILOG_FUNCTION_NAME_MAX_LENGTH + 12] = {0};
-    memset(temp_str, 0, sizeof(temp_str));
-    /* 时间 */
-    log_size += flog_strcat(flog.line_buffer + log_size, "[", FLEXILOG_LINE_MAX_LENGTH);
-    log_size += flog_strcat(flog.line_buffer + log_size, flog_port_get_time(), FLEXILOG_LINE_MAX_LENGTH);
-    log_size += flog_strcat(flog.line_buffer + log_size, "]", FLEXILOG_LINE_MAX_LENGTH);
-
-    /* 事件 */
-    log_size += flog_strcat(flog.line_buffer + log_size, "[", FLEXILOG_LINE_MAX_LENGTH);
-    log_size += flog_strcat(flog.line_buffer + log_size, "event:", FLEXILOG_LINE_MAX_LENGTH);
-    snprintf(temp_str, sizeof(temp_str), "%d", event);
-    log_size += flog_strcat(flog.line_buffer + log_size, temp_str, FLEXILOG_LINE_MAX_LENGTH);
-    log_size += flog_strcat(flog.line_buffer + log_size, "]", FLEXILOG_LINE_MAX_LENGTH);
+    uint32_t offset;    /* 第一行的地址 */
+    uint16_t title_len; /* 标题长度, FLOG_HEX_DUMP_NO_TITLE表示没有标题 */
+    uint8_t unit;       /* 每组字节数 */
+    uint8_t reserved;
+}flog_hex_dump_head_t;
 
-    memset(temp_str, 0, sizeof(temp_str));
+#define FLOG_HEX_DUMP_NO_TITLE  UINT16_MAX
 
-    /* 函数 */
-    snprintf(temp_str, sizeof(temp_str), "(%s:%d,%s()): ", file, line, func);
-    log_size += flog_strcat(flog.line_buffer + log_size, temp_str, FLEXILOG_LINE_MAX_LENGTH);
-
-    /* 格式化日志 */
-    va_list args;
-    va_start(args, fmt);
-    log_size += vsnprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, fmt, args);
-    va_end(args);
-
-    log_size += flog_strcat(flog.line_buffer + log_size, FLOG_NEW_LINE, FLEXILOG_LINE_MAX_LENGTH);
-    FLOG_LOCK();
-    flog_write_event_ring_buffer(event, flog.line_buffer, log_size);
-#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
-    flog_rb_write_force(&flog.ring_buffer_all, flog.line_buffer, log_size);
-    if (!flog.hardware_output_enable)
+/**
+ * @brief 以二进制记录保存十六进制输出
+ * @note  每条记录的行数与文本输出一次提交的行数相同, 渲染后不超过FLEXILOG_LINE_MAX_LENGTH
+ * @param title 标题, 可以为NULL
+ * @param title_len 标题长度
+ * @param data 数据
+ * @param size 数据大小
+ * @param unit 每组字节数
+ * @param rows 每条记录的行数
+ */
+static void flog_hex_dump_capture(const char *title, uint32_t title_len, const uint8_t *data, uint32_t size,
+                                  uint32_t unit, uint32_t rows)
+{
+    uint32_t pos = 0;
+    flog_hex_dump_head_t head;
+    head.title_len = title ? (uint16_t)title_len : FLOG_HEX_DUMP_NO_TITLE;
+    head.unit = (uint8_t)unit;
+    head.reserved = 0;
+    if (title && sizeof(head) + title_len >= FLEXILOG_LINE_MAX_LENGTH)
+    {
         return;
-#endif  // FLEXILOG_USE_ALL_LOG_RING_BUFFER
-
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    flog_rb_write_force(&flog.ring_buffer_output, flog.line_buffer, log_size);
-#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
+    }
+    /* 行数同时受记录大小限制 */
+    if (rows * FLOG_HEX_DUMP_ROW_BYTES > FLEXILOG_LINE_MAX_LENGTH - sizeof(head) - (title ? title_len : 0))
+    {
+        rows = (FLEXILOG_LINE_MAX_LENGTH - sizeof(head) - (title ? title_len : 0)) / FLOG_HEX_DUMP_ROW_BYTES;
+    }
+    do
+    {
+        uint32_t record_size = sizeof(head);
+        uint32_t count = (size - pos < rows * FLOG_HEX_DUMP_ROW_BYTES) ? size - pos : rows * FLOG_HEX_DUMP_ROW_BYTES;
+        char *record = NULL;
+        FLOG_FORMAT_LOCK();
+        record = flog_get_context()->line_buffer;
+        head.offset = pos;
+        memcpy(record, &head, sizeof(head));
+        if (title)
+        {
+            memcpy(record + record_size, title, title_len);
+            record_size += title_len;
+        }
+        memcpy(record + record_size, data + pos, count);
+        record_size += count;
+        flog_commit(record, record_size, FLOG_LEVEL_UNVALID, FLOG_TARGET_ALL | FLOG_TARGET_OUTPUT | FLOG_RB_RECORD_BINARY, 0);
+        FLOG_FORMAT_UNLOCK();
+        pos += count;
+    } while (pos < size);
+}
 
-    flog_port_output(flog.line_buffer, log_size);
-    FLOG_UNLOCK();
+/**
+ * @brief 渲染十六进制输出记录
+ * @param head 记录头
+ * @param record 记录内容
+ * @param text 文本缓冲区
+ * @param size 文本缓冲区大小
+ * @return 完整文本的长度
+ */
+static uint32_t flog_hex_dump_render_record(const flog_rb_record_t *head, const char *record, char *text, uint32_t size)
+{
+    flog_hex_dump_head_t dump;
+    const char *title = NULL;
+    uint32_t title_len = 0;
+    uint32_t data_size = 0;
+    uint32_t log_size = 0;
+    if (head->length < sizeof(dump))
+    {
+        return 0;
+    }
+    memcpy(&dump, record, sizeof(dump));
+    data_size = head->length - sizeof(dump);
+    if (dump.title_len != FLOG_HEX_DUMP_NO_TITLE)
+    {
+        if (dump.title_len > data_size)
+        {
+            return 0;
+        }
+        title = record + sizeof(dump);
+        title_len = dump.title_len;
+        data_size -= title_len;
+    }
+    if (dump.unit != 1 && dump.unit != 2 && dump.unit != 4)
+    {
+        return 0;
+    }
+    /* 行长度固定, 空间不足时不渲染 */
+    log_size = flog_hex_dump_row_size(title, &title_len, dump.unit)
+               * ((data_size + FLOG_HEX_DUMP_ROW_BYTES - 1) / FLOG_HEX_DUMP_ROW_BYTES);
+    if (log_size >= size)
+    {
+        return log_size;
+    }
+    log_size = 0;
+    const uint8_t *data = (const uint8_t *)record + head->length - data_size;
+    for (uint32_t pos = 0; pos < data_size; pos += FLOG_HEX_DUMP_ROW_BYTES)
+    {
+        uint32_t count = (data_size - pos < FLOG_HEX_DUMP_ROW_BYTES) ? data_size - pos : FLOG_HEX_DUMP_ROW_BYTES;
+        log_size += flog_hex_dump_row(text + log_size, title, title_len, data + pos, dump.offset + pos, count, dump.unit);
+    }
+    return log_size;
 }
-#endif // FLEXILOG_USE_EVENT_LOG_RING_BUFFER
+#endif // FLEXILOG_USE_BINARY_HEX_DUMP
 
+#if defined(FLEXILOG_USE_DEFERRED_FORMAT) || defined(FLEXILOG_USE_BINARY_HEX_DUMP)
+/**
+ * @brief 渲染二进制记录
+ * @note  十六进制输出记录没有等级, 其他二进制记录是延迟格式化的日志
+ * @param head 记录头
+ * @param record 记录内容
+ * @param text 文本缓冲区
+ * @param size 文本缓冲区大小
+ * @return 完整文本的长度
+ */
+static uint32_t flog_render_record(const flog_rb_record_t *head, const char *record, char *text, uint32_t size)
+{
+#ifdef FLEXILOG_USE_BINARY_HEX_DUMP
+    if (head->level == FLOG_LEVEL_UNVALID)
+    {
+        return flog_hex_dump_render_record(head, record, text, size);
+    }
+#endif // FLEXILOG_USE_BINARY_HEX_DUMP
+#ifdef FLEXILOG_USE_DEFERRED_FORMAT
+    return flog_defer_render_record(head, record, text, size);
+#else
+    return 0;
+#endif // FLEXILOG_USE_DEFERRED_FORMAT
+}
+#endif // FLEXILOG_USE_DEFERRED_FORMAT || FLEXILOG_USE_BINARY_HEX_DUMP
 
 /**
  * @brief 十六进制输出
  * @note 支持按字节，半字，字数据进行输出
- * @note 支持任意长度数据，不受FLEXILOG_LINE_MAX_LENGTH限制
+ * @note 支持任意长度数据，不受FLEXILOG_LINE_MAX_LENGTH限制, 按行填满行缓冲区后分段输出
+ * @note 不使用静态变量, 多个线程可以同时输出
+ * @note 启用FLEXILOG_USE_BINARY_HEX_DUMP时环形缓冲区只保存原始数据, 只有开启硬件输出时才渲染文本
  * @param title 标题信息
  * @param data  数据
  * @param size 数据大小
@@ -839,100 +3013,58 @@ void flog_output_event(FLOG_EVENT event, const char *file, const char *func, uin
  */
 void flog_hex_dump(char *title, void *data, uint32_t size, FLOG_DATA_TYPE type)
 {
-    uint32_t log_size = 0;
-    static uint32_t pos = 0;
-    static char ascii[17] = {0};
-    uint8_t ascii_pos = 0;
-    uint8_t line_size =0;
+    uint32_t unit = 0;
+    uint32_t title_len = 0;
+    uint32_t row_size = 0;
+    uint32_t pos = 0;
+    uint8_t target = FLOG_TARGET_ALL | FLOG_TARGET_OUTPUT | FLOG_TARGET_HARDWARE;
     flexlog_assert(data != NULL);
     switch (type)
     {
         case FLOG_DATA_TYPE_BYTE:
-            line_size = (title) ? (81 - strlen(title) - 1) : 81;    // 单行打印长度
-            for (; pos < size; pos++)
-            {
-                if (pos % 16 == 0)
-                {
-                    if (title){
-                        log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "%s ", title);
-                    }
-                    log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "0x%08X ", pos);
-                }
-                log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "%02X ", ((uint8_t *)data)[pos]);
-                ascii[ascii_pos++] = ((((char *)data)[pos] >= ' ') && (((char *)data)[pos] <= '~')) ? ((char *)data)[pos] : '.';
-
-                /* 16字节打印结束 添加对应ascii码 并处理递归打印逻辑 */
-                FLOG_HEX_DUMP_APPEND_ASCII(pos, 1);
-            }
-            /* 最后不足16字节 打印占位符 */
-            FLOG_HEX_DUMP_TAIL_DEEL(pos, 1);
+            unit = 1;
             break;
         case FLOG_DATA_TYPE_HALF_WORD:
-            line_size = (title) ? (73 - strlen(title) - 1) : 73;    // 单行打印长度
-            if (size % 2 != 0)
-                return;
-            for (; pos < size - 1; pos += 2)
-            {
-                if (pos % 16 == 0)
-                {
-                    if (title){
-                        log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "%s ", title);
-                    }
-                    log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "0x%08X ", pos);
-                }
-                log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "%02X%02X ", ((uint8_t *)data)[pos + 1], ((uint8_t *)data)[pos]);
-                ascii[ascii_pos++] = ((((char *)data)[pos] >= ' ') && (((char *)data)[pos] <= '~')) ? ((char *)data)[pos] : '.';
-                ascii[ascii_pos++] = ((((char *)data)[pos + 1] >= ' ') && (((char *)data)[pos + 1] <= '~')) ? ((char *)data)[pos + 1] : '.';
-
-                /* 16字节打印结束 添加对应ascii码 并处理递归打印逻辑 */
-                FLOG_HEX_DUMP_APPEND_ASCII(pos, 2);
-            }
-            /* 最后不足16字节 打印占位符 */
-            FLOG_HEX_DUMP_TAIL_DEEL(pos, 2);
+            unit = 2;
             break;
         case FLOG_DATA_TYPE_WORD:
-            line_size = (title) ? (69 - strlen(title) - 1) : 69;    // 单行打印长度
-            if (size % 4 != 0)
-                return;
-            for (; pos < size - 3; pos += 4)
-            {
-                if (pos % 16 == 0)
-                {
-                    if (title){
-                        log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "%s ", title);
-                    }
-                    log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "0x%08X ", pos);
-                }
-                log_size += snprintf(flog.line_buffer + log_size, FLEXILOG_LINE_MAX_LENGTH, "%02X%02X%02X%02X ", ((uint8_t *)data)[pos + 3], ((uint8_t *)data)[pos + 2], ((uint8_t *)data)[pos + 1], ((uint8_t *)data)[pos]);
-                ascii[ascii_pos++] = ((((char *)data)[pos] >= ' ') && (((char *)data)[pos] <= '~')) ? ((char *)data)[pos] : '.';
-                ascii[ascii_pos++] = ((((char *)data)[pos + 1] >= ' ') && (((char *)data)[pos + 1] <= '~')) ? ((char *)data)[pos + 1] : '.';
-                ascii[ascii_pos++] = ((((char *)data)[pos + 2] >= ' ') && (((char *)data)[pos + 2] <= '~')) ? ((char *)data)[pos + 2] : '.';
-                ascii[ascii_pos++] = ((((char *)data)[pos + 3] >= ' ') && (((char *)data)[pos + 3] <= '~')) ? ((char *)data)[pos + 3] : '.';
-
-                /* 16字节打印结束 添加对应ascii码 并处理递归打印逻辑 */
-                FLOG_HEX_DUMP_APPEND_ASCII(pos, 4);
-            }
-            /* 最后不足16字节 打印占位符 */
-            FLOG_HEX_DUMP_TAIL_DEEL(pos, 4);
+            unit = 4;
             break;
         default:
-            break;
+            return;
     }
-    output:
-    FLOG_LOCK();
-#ifdef FLEXILOG_USE_ALL_LOG_RING_BUFFER
-    flog_rb_write_force(&flog.ring_buffer_all, flog.line_buffer, log_size);
-#endif // FLEXILOG_USE_ALL_LOG_RING_BUFFER
-#ifdef FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    flog_rb_write_force(&flog.ring_buffer_output, flog.line_buffer, log_size);
-#endif // FLEXILOG_USE_OUTPUT_LOG_RING_BUFFER
-    flog_port_output(flog.line_buffer, log_size);
-    FLOG_UNLOCK();
-    /* 递归直到打印完成 */
-    if (pos < size){
-        flog_hex_dump(title, data, size, type);
+    if (size % unit != 0)
+    {
+        return;
+    }
+    if (title)
+    {
+        title_len = flog_strlen(title);
     }
-    else{
-        pos = 0;
+    row_size = flog_hex_dump_row_size(title, &title_len, unit);
+
+#ifdef FLEXILOG_USE_BINARY_HEX_DUMP
+    flog_hex_dump_capture(title, title_len, (const uint8_t *)data, size, unit, FLEXILOG_LINE_MAX_LENGTH / row_size);
+    if (!flog.hardware_output_enable)
+    {
+        return;
     }
+    target = FLOG_TARGET_HARDWARE;
+#endif // FLEXILOG_USE_BINARY_HEX_DUMP
+    do
+    {
+        uint32_t log_size = 0;
+        char *line_buffer = NULL;
+        FLOG_FORMAT_LOCK();
+        line_buffer = flog_get_context()->line_buffer;
+        /* 行缓冲区还能放下一行时继续填充 */
+        while (pos < size && log_size + row_size <= FLEXILOG_LINE_MAX_LENGTH)
+        {
+            uint32_t count = (size - pos < FLOG_HEX_DUMP_ROW_BYTES) ? size - pos : FLOG_HEX_DUMP_ROW_BYTES;
+            log_size += flog_hex_dump_row(line_buffer + log_size, title, title_len, (const uint8_t *)data + pos, pos, count, unit);
+            pos += count;
+        }
+        flog_commit(line_buffer, log_size, FLOG_LEVEL_UNVALID, target, 0);
+        FLOG_FORMAT_UNLOCK();
+    } while (pos < size);
 }
@@ -0,0 +1,408 @@
+/**
+ * ==================================================
+ *  @file flexi_log_defer.c
+ *  @brief flexi log 延迟格式化实现文件
+ *  @note  写入时按格式字符串把参数原样打包, 读取时再逐个转换说明符调用flog_snprintf还原文本
+ *  @note  字符串参数会被拷贝, 其他参数按类型保存原始字节; 不支持%n和宽字符
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-18 下午9:05
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#include "flexi_log_defer.h"
+#include "flexi_log.h"
+#ifdef FLEXILOG_USE_DEFERRED_FORMAT
+#include "flexi_log_format.h"
+#include "string.h"
+#include "stddef.h"
+
+#define FLOG_DEFER_SPEC_MAX 32  /* 单个转换说明符最大长度 */
+
+/* 参数类型 */
+typedef enum
+{
+    FLOG_ARG_LITERAL = 0,   /* %% */
+    FLOG_ARG_INT,
+    FLOG_ARG_LONG,
+    FLOG_ARG_LLONG,
+    FLOG_ARG_INTMAX,
+    FLOG_ARG_SIZE,
+    FLOG_ARG_PTRDIFF,
+    FLOG_ARG_DOUBLE,
+    FLOG_ARG_LDOUBLE,
+    FLOG_ARG_PTR,
+    FLOG_ARG_STR,
+    FLOG_ARG_UNSUPPORTED
+}FLOG_ARG_TYPE;
+
+/* 长度修饰符 */
+typedef enum
+{
+    FLOG_LEN_NONE = 0,
+    FLOG_LEN_H,
+    FLOG_LEN_L,
+    FLOG_LEN_LL,
+    FLOG_LEN_BIG_L,
+    FLOG_LEN_J,
+    FLOG_LEN_Z,
+    FLOG_LEN_T
+}FLOG_LEN_TYPE;
+
+/* 转换说明符 */
+typedef struct
+{
+    const char *start;      /* 说明符起始位置 */
+    uint32_t length;        /* 说明符长度 */
+    bool width_star;        /* 宽度由参数提供 */
+    bool precision_star;    /* 精度由参数提供 */
+    int precision;          /* 精度, -1表示未指定 */
+    FLOG_ARG_TYPE type;     /* 参数类型 */
+}flog_spec_t;
+
+/**
+ * @brief 解析一个转换说明符
+ * @param fmt 指向'%'
+ * @param spec 输出说明符
+ * @return 说明符之后的位置
+ */
+static const char *flog_defer_parse(const char *fmt, flog_spec_t *spec)
+{
+    const char *p = fmt + 1;
+    FLOG_LEN_TYPE len = FLOG_LEN_NONE;
+    spec->start = fmt;
+    spec->width_star = false;
+    spec->precision_star = false;
+    spec->precision = -1;
+    spec->type = FLOG_ARG_UNSUPPORTED;
+    if (*p == '%')
+    {
+        spec->type = FLOG_ARG_LITERAL;
+        spec->length = 2;
+        return p + 1;
+    }
+
+    /* 标志 */
+    while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'')
+    {
+        p++;
+    }
+    /* 宽度 */
+    if (*p == '*')
+    {
+        spec->width_star = true;
+        p++;
+    }
+    else
+    {
+        while (*p >= '0' && *p <= '9')
+        {
+            p++;
+        }
+    }
+    /* 精度 */
+    if (*p == '.')
+    {
+        p++;
+        if (*p == '*')
+        {
+            spec->precision_star = true;
+            p++;
+        }
+        else
+        {
+            spec->precision = 0;
+            while (*p >= '0' && *p <= '9')
+            {
+                spec->precision = spec->precision * 10 + (*p++ - '0');
+            }
+        }
+    }
+    /* 长度 */
+    switch (*p)
+    {
+        case 'h':
+            p += (p[1] == 'h') ? 2 : 1;
+            len = FLOG_LEN_H;
+            break;
+        case 'l':
+            if (p[1] == 'l')
+            {
+                p += 2;
+                len = FLOG_LEN_LL;
+            }
+            else
+            {
+                p += 1;
+                len = FLOG_LEN_L;
+            }
+            break;
+        case 'L': p++; len = FLOG_LEN_BIG_L; break;
+        case 'j': p++; len = FLOG_LEN_J; break;
+        case 'z': p++; len = FLOG_LEN_Z; break;
+        case 't': p++; len = FLOG_LEN_T; break;
+        default: break;
+    }
+    /* 转换 */
+    switch (*p)
+    {
+        case 'd': case 'i': case 'o': case 'u': case 'x': case 'X':
+            switch (len)
+            {
+                case FLOG_LEN_NONE:
+                case FLOG_LEN_H:    spec->type = FLOG_ARG_INT; break;
+                case FLOG_LEN_L:    spec->type = FLOG_ARG_LONG; break;
+                case FLOG_LEN_LL:
+                case FLOG_LEN_BIG_L:spec->type = FLOG_ARG_LLONG; break;
+                case FLOG_LEN_J:    spec->type = FLOG_ARG_INTMAX; break;
+                case FLOG_LEN_Z:    spec->type = FLOG_ARG_SIZE; break;
+                case FLOG_LEN_T:    spec->type = FLOG_ARG_PTRDIFF; break;
+            }
+            break;
+        case 'c':
+            spec->type = (len == FLOG_LEN_NONE) ? FLOG_ARG_INT : FLOG_ARG_UNSUPPORTED;
+            break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G': case 'a': case 'A':
+            spec->type = (len == FLOG_LEN_BIG_L) ? FLOG_ARG_LDOUBLE : FLOG_ARG_DOUBLE;
+            break;
+        case 'p':
+            spec->type = FLOG_ARG_PTR;
+            break;
+        case 's':
+            spec->type = (len == FLOG_LEN_NONE) ? FLOG_ARG_STR : FLOG_ARG_UNSUPPORTED;
+            break;
+        default:
+            break;
+    }
+    if (*p)
+    {
+        p++;
+    }
+    spec->length = (uint32_t)(p - fmt);
+    return p;
+}
+
+/**
+ * @brief 打包一个字符串
+ * @param buffer 打包缓冲区
+ * @param size 缓冲区大小
+ * @param str 字符串
+ * @param max_len 最大拷贝长度, -1表示不限制
+ * @return 占用的字节大小(含结束符), 0表示空间不足
+ */
+static uint32_t flog_defer_put_string(char *buffer, uint32_t size, const char *str, int max_len)
+{
+    uint32_t len = 0;
+    if (size == 0)
+    {
+        return 0;
+    }
+    if (str == NULL)
+    {
+        str = "(null)";
+    }
+    while (len < size - 1 && str[len] && (max_len < 0 || len < (uint32_t)max_len))
+    {
+        buffer[len] = str[len];
+        len++;
+    }
+    buffer[len] = '\0';
+    return len + 1;
+}
+
+/**
+ * @brief 打包一个字符串
+ * @note  超出空间的部分会被截断
+ * @param buffer 打包缓冲区
+ * @param size 缓冲区大小
+ * @param str 字符串
+ * @return 占用的字节大小(含结束符), 0表示空间不足
+ */
+uint32_t flog_defer_pack_string(char *buffer, uint32_t size, const char *str)
+{
+    return flog_defer_put_string(buffer, size, str, -1);
+}
+
+#define FLOG_DEFER_PUT(type)    do                                          \
+                                {                                           \
+                                    type value = va_arg(args, type);        \
+                                    if (pos + sizeof(value) > size)         \
+                                        return false;                       \
+                                    memcpy(buffer + pos, &value, sizeof(value)); \
+                                    pos += sizeof(value);                   \
+                                }while(0)
+
+/**
+ * @brief 按格式字符串打包参数
+ * @param buffer 打包缓冲区
+ * @param size 缓冲区大小
+ * @param fmt 格式
+ * @param args 参数
+ * @param pack_size 输出打包的字节大小
+ * @return true 打包成功
+ * @return false 含有不支持的说明符或空间不足, 需要立即格式化
+ */
+bool flog_defer_pack(char *buffer, uint32_t size, const char *fmt, va_list args, uint32_t *pack_size)
+{
+    flexlog_assert(buffer);
+    flexlog_assert(fmt);
+    uint32_t pos = 0;
+    uint32_t str_size = 0;
+    flog_spec_t spec;
+    while (*fmt)
+    {
+        if (*fmt != '%')
+        {
+            fmt++;
+            continue;
+        }
+        fmt = flog_defer_parse(fmt, &spec);
+        if (spec.type == FLOG_ARG_LITERAL)
+        {
+            continue;
+        }
+        if (spec.type == FLOG_ARG_UNSUPPORTED || spec.length >= FLOG_DEFER_SPEC_MAX)
+        {
+            return false;
+        }
+        if (spec.width_star)
+        {
+            FLOG_DEFER_PUT(int);
+        }
+        if (spec.precision_star)
+        {
+            FLOG_DEFER_PUT(int);
+            memcpy(&spec.precision, buffer + pos - sizeof(int), sizeof(int));
+        }
+        switch (spec.type)
+        {
+            case FLOG_ARG_INT:      FLOG_DEFER_PUT(int); break;
+            case FLOG_ARG_LONG:     FLOG_DEFER_PUT(long); break;
+            case FLOG_ARG_LLONG:    FLOG_DEFER_PUT(long long); break;
+            case FLOG_ARG_INTMAX:   FLOG_DEFER_PUT(intmax_t); break;
+            case FLOG_ARG_SIZE:     FLOG_DEFER_PUT(size_t); break;
+            case FLOG_ARG_PTRDIFF:  FLOG_DEFER_PUT(ptrdiff_t); break;
+            case FLOG_ARG_DOUBLE:   FLOG_DEFER_PUT(double); break;
+            case FLOG_ARG_LDOUBLE:  FLOG_DEFER_PUT(long double); break;
+            case FLOG_ARG_PTR:      FLOG_DEFER_PUT(void *); break;
+            case FLOG_ARG_STR:
+                /* 字符串可能在栈上, 必须拷贝内容 */
+                str_size = flog_defer_put_string(buffer + pos, size - pos, va_arg(args, const char *), spec.precision);
+                if (str_size == 0)
+                    return false;
+                pos += str_size;
+                break;
+            default:
+                return false;
+        }
+    }
+    *pack_size = pos;
+    return true;
+}
+
+#define FLOG_DEFER_GET(value)   do                                          \
+                                {                                           \
+                                    if (arg_pos + sizeof(value) > args_size) \
+                                        goto end;                           \
+                                    memcpy(&(value), args + arg_pos, sizeof(value)); \
+                                    arg_pos += sizeof(value);               \
+                                }while(0)
+
+#define FLOG_DEFER_PRINT(value) ((spec.width_star && spec.precision_star) ? flog_snprintf(text + pos, size - pos, spec_str, width, precision, value) \
+                                : spec.width_star ? flog_snprintf(text + pos, size - pos, spec_str, width, value)                                 \
+                                : spec.precision_star ? flog_snprintf(text + pos, size - pos, spec_str, precision, value)                         \
+                                : flog_snprintf(text + pos, size - pos, spec_str, value))
+
+/**
+ * @brief 渲染打包的参数
+ * @param text 文本缓冲区
+ * @param size 文本缓冲区大小
+ * @param fmt 格式
+ * @param args 打包的参数
+ * @param args_size 打包的参数大小
+ * @return 写入的文本长度, 不含结束符
+ */
+uint32_t flog_defer_render(char *text, uint32_t size, const char *fmt, const char *args, uint32_t args_size)
+{
+    flexlog_assert(text);
+    flexlog_assert(fmt);
+    if (size == 0)
+    {
+        return 0;
+    }
+    uint32_t pos = 0;
+    uint32_t arg_pos = 0;
+    int ret = 0;
+    int width = 0;
+    int precision = 0;
+    char spec_str[FLOG_DEFER_SPEC_MAX];
+    flog_spec_t spec;
+    while (*fmt && pos < size - 1)
+    {
+        if (*fmt != '%')
+        {
+            text[pos++] = *fmt++;
+            continue;
+        }
+        fmt = flog_defer_parse(fmt, &spec);
+        if (spec.type == FLOG_ARG_LITERAL)
+        {
+            text[pos++] = '%';
+            continue;
+        }
+        if (spec.type == FLOG_ARG_UNSUPPORTED || spec.length >= FLOG_DEFER_SPEC_MAX)
+        {
+            break;
+        }
+        memcpy(spec_str, spec.start, spec.length);
+        spec_str[spec.length] = '\0';
+        if (spec.width_star)
+        {
+            FLOG_DEFER_GET(width);
+        }
+        if (spec.precision_star)
+        {
+            FLOG_DEFER_GET(precision);
+        }
+        switch (spec.type)
+        {
+            case FLOG_ARG_INT:      { int value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_LONG:     { long value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_LLONG:    { long long value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_INTMAX:   { intmax_t value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_SIZE:     { size_t value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_PTRDIFF:  { ptrdiff_t value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_DOUBLE:   { double value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_LDOUBLE:  { long double value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_PTR:      { void *value; FLOG_DEFER_GET(value); ret = FLOG_DEFER_PRINT(value); break; }
+            case FLOG_ARG_STR:
+            {
+                const char *value = args + arg_pos;
+                uint32_t len = 0;
+                while (arg_pos + len < args_size && value[len])
+                {
+                    len++;
+                }
+                if (arg_pos + len >= args_size)
+                {
+                    goto end;
+                }
+                arg_pos += len + 1;
+                ret = FLOG_DEFER_PRINT(value);
+                break;
+            }
+            default:
+                goto end;
+        }
+        if (ret > 0)
+        {
+            pos += ((uint32_t)ret >= size - pos) ? (size - pos - 1) : (uint32_t)ret;
+        }
+    }
+    end:
+    text[pos] = '\0';
+    return pos;
+}
+#endif // FLEXILOG_USE_DEFERRED_FORMAT
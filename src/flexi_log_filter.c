@@ -0,0 +1,205 @@
+/**
+ * ==================================================
+ *  @file flexi_log_filter.c
+ *  @brief flexi log tag过滤规则实现文件
+ *  @note  tag按分隔符分级, 规则保存在按级展开的前缀树中, 例如"net.*=WARN, net.tcp=DEBUG"
+ *  @note  匹配时取最深的命中规则: "net.tcp.rx"为DEBUG, "net.udp"为WARN, "net"不受"net.*"影响
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-20 下午8:30
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#include "flexi_log_filter.h"
+#include "flexi_log.h"
+#if (FLEXILOG_TAG_FILTER_NUM > 0)
+#include "string.h"
+
+/**
+ * @brief 获取tag中的一级
+ * @param str  本级起始位置
+ * @param end  返回本级结束位置(分隔符或字符串结尾)
+ * @return 本级参与比较的长度
+ */
+static uint32_t flog_filter_segment(const char *str, const char **end)
+{
+    const char *pos = str;
+    while (*pos && *pos != FLOG_FILTER_SEPARATOR)
+    {
+        pos++;
+    }
+    *end = pos;
+    return (pos - str) > FLEXILOG_TAG_MAX_LENGTH ? FLEXILOG_TAG_MAX_LENGTH : (uint32_t)(pos - str);
+}
+
+/**
+ * @brief 查找子节点
+ * @param filter 规则树
+ * @param parent 父节点
+ * @param name   本级名称
+ * @param len    本级名称长度
+ * @return 子节点, 没有返回FLOG_FILTER_NODE_NONE
+ */
+static uint16_t flog_filter_find_child(const flog_filter_t *filter, uint16_t parent, const char *name, uint32_t len)
+{
+    for (uint16_t node = filter->nodes[parent].child; node != FLOG_FILTER_NODE_NONE; node = filter->nodes[node].sibling)
+    {
+        if (strncmp(filter->nodes[node].name, name, len) == 0 && filter->nodes[node].name[len] == '\0')
+            return node;
+    }
+    return FLOG_FILTER_NODE_NONE;
+}
+
+/**
+ * @brief 回收没有规则的叶子节点
+ * @note  删除规则后调用, 回收后父节点可能也变为叶子节点, 重复直到没有可回收的节点
+ * @param filter 规则树
+ */
+static void flog_filter_prune(flog_filter_t *filter)
+{
+    bool pruned = true;
+    while (pruned)
+    {
+        pruned = false;
+        for (uint16_t parent = 0; parent < filter->node_num; ++parent)
+        {
+            uint16_t *link = &filter->nodes[parent].child;
+            while (*link != FLOG_FILTER_NODE_NONE)
+            {
+                flog_filter_node_t *node = &filter->nodes[*link];
+                if (node->child != FLOG_FILTER_NODE_NONE || node->level != FLOG_FILTER_LEVEL_NONE ||
+                    node->wildcard_level != FLOG_FILTER_LEVEL_NONE)
+                {
+                    link = &node->sibling;
+                    continue;
+                }
+                /* 从兄弟链表中摘下, 放入空闲链表 */
+                uint16_t index = *link;
+                *link = node->sibling;
+                node->name[0] = '\0';
+                node->sibling = filter->free_node;
+                filter->free_node = index;
+                pruned = true;
+            }
+        }
+    }
+}
+
+/**
+ * @brief 初始化规则树
+ * @param filter 规则树
+ */
+void flog_filter_init(flog_filter_t *filter)
+{
+    flexlog_assert(filter != NULL)
+    memset(filter, 0, sizeof(flog_filter_t));
+    filter->nodes[0].level = FLOG_FILTER_LEVEL_NONE;
+    filter->nodes[0].wildcard_level = FLOG_FILTER_LEVEL_NONE;
+    filter->node_num = 1;
+}
+
+/**
+ * @brief 设置规则
+ * @note  "a.b"作用于a.b及其下级, "a.b.*"只作用于a.b的下级, "*"作用于所有tag
+ * @param filter  规则树
+ * @param pattern 规则
+ * @param level   等级, FLOG_FILTER_LEVEL_NONE表示删除规则, 删除后回收不再使用的节点
+ * @return true   设置成功
+ * @return false  规则格式错误或节点已用完
+ */
+bool flog_filter_set(flog_filter_t *filter, const char *pattern, uint8_t level)
+{
+    flexlog_assert(filter != NULL)
+    flexlog_assert(pattern != NULL)
+    uint16_t node = 0;
+    const char *end = NULL;
+    while (1)
+    {
+        uint32_t len = flog_filter_segment(pattern, &end);
+        if (len == 0)
+            return false;
+        if (len == 1 && *pattern == FLOG_FILTER_WILDCARD[0])
+        {
+            if (*end != '\0')
+                return false;
+            filter->nodes[node].wildcard_level = level;
+            if (level == FLOG_FILTER_LEVEL_NONE)
+                flog_filter_prune(filter);
+            return true;
+        }
+
+        uint16_t child = flog_filter_find_child(filter, node, pattern, len);
+        if (child == FLOG_FILTER_NODE_NONE)
+        {
+            if (level == FLOG_FILTER_LEVEL_NONE)
+                return true;
+            if (filter->free_node != FLOG_FILTER_NODE_NONE)
+            {
+                child = filter->free_node;
+                filter->free_node = filter->nodes[child].sibling;
+            }
+            else if (filter->node_num < FLEXILOG_TAG_RULE_NODE_NUM)
+            {
+                child = filter->node_num++;
+            }
+            else
+            {
+                return false;
+            }
+            memcpy(filter->nodes[child].name, pattern, len);
+            filter->nodes[child].name[len] = '\0';
+            filter->nodes[child].level = FLOG_FILTER_LEVEL_NONE;
+            filter->nodes[child].wildcard_level = FLOG_FILTER_LEVEL_NONE;
+            filter->nodes[child].child = FLOG_FILTER_NODE_NONE;
+            filter->nodes[child].sibling = filter->nodes[node].child;
+            filter->nodes[node].child = child;
+        }
+        node = child;
+        if (*end == '\0')
+        {
+            filter->nodes[node].level = level;
+            if (level == FLOG_FILTER_LEVEL_NONE)
+                flog_filter_prune(filter);
+            return true;
+        }
+        pattern = end + 1;
+    }
+}
+
+/**
+ * @brief 计算tag的生效等级
+ * @note  逐级向下匹配, 更深的规则覆盖更浅的规则, 同一级上"a.*"优先于"a"
+ * @param filter 规则树
+ * @param tag    tag
+ * @return 生效等级, 没有命中的规则返回FLOG_FILTER_LEVEL_NONE
+ */
+uint8_t flog_filter_resolve(const flog_filter_t *filter, const char *tag)
+{
+    flexlog_assert(filter != NULL)
+    flexlog_assert(tag != NULL)
+    uint8_t level = filter->nodes[0].wildcard_level;
+    uint16_t node = 0;
+    const char *end = NULL;
+    while (1)
+    {
+        uint32_t len = flog_filter_segment(tag, &end);
+        node = flog_filter_find_child(filter, node, tag, len);
+        if (node == FLOG_FILTER_NODE_NONE)
+            break;
+        if (*end == '\0')
+        {
+            if (filter->nodes[node].level != FLOG_FILTER_LEVEL_NONE)
+                level = filter->nodes[node].level;
+            break;
+        }
+        if (filter->nodes[node].wildcard_level != FLOG_FILTER_LEVEL_NONE)
+            level = filter->nodes[node].wildcard_level;
+        else if (filter->nodes[node].level != FLOG_FILTER_LEVEL_NONE)
+            level = filter->nodes[node].level;
+        tag = end + 1;
+    }
+    return level;
+}
+#endif // FLEXILOG_TAG_FILTER_NUM > 0
@@ -0,0 +1,657 @@
+/**
+ * ==================================================
+ *  @file flexi_log_format.c
+ *  @brief flexi log 内置格式化实现文件
+ *  @note  实现日志常用的printf子集, 直接写入目标缓冲区, 不依赖libc的stdio和locale
+ *  @note  支持%d %i %u %o %x %X %c %s %p %f %F %%, 标志"-+ #0", 宽度和精度(含*), 长度hh h l ll j z t L
+ *  @note  %e %E %g %G %a %A按%f输出, 小数最多计算9位, 更多的位数补0; %n和宽字符%lc %ls原样输出说明符
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-23 下午7:40
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#include "flexi_log_format.h"
+#include "flexi_log.h"
+#ifdef FLEXILOG_USE_BUILTIN_FORMAT
+#include "flexi_log_until.h"
+#include "string.h"
+#include "stddef.h"
+
+#define FLOG_FORMAT_NUMBER_MAX      24  /* 64位数的最长数字(八进制22位) */
+#define FLOG_FORMAT_FRACTION_MAX    9   /* 实际计算的小数位数 */
+#define FLOG_FORMAT_FLOAT_LIMIT     1e19 /* 整数部分超过该值时逐次除10, 只保证前15位有效数字 */
+
+/* 标志 */
+#define FLOG_FORMAT_FLAG_LEFT       (0x01 << 0) /* '-' 左对齐 */
+#define FLOG_FORMAT_FLAG_PLUS       (0x01 << 1) /* '+' 正数显示+ */
+#define FLOG_FORMAT_FLAG_SPACE      (0x01 << 2) /* ' ' 正数显示空格 */
+#define FLOG_FORMAT_FLAG_ALT        (0x01 << 3) /* '#' 显示进制前缀 */
+#define FLOG_FORMAT_FLAG_ZERO       (0x01 << 4) /* '0' 用0填充宽度 */
+
+/* 长度修饰符 */
+typedef enum
+{
+    FLOG_FORMAT_LEN_NONE = 0,
+    FLOG_FORMAT_LEN_HH,
+    FLOG_FORMAT_LEN_H,
+    FLOG_FORMAT_LEN_L,
+    FLOG_FORMAT_LEN_LL,
+    FLOG_FORMAT_LEN_J,
+    FLOG_FORMAT_LEN_Z,
+    FLOG_FORMAT_LEN_T,
+    FLOG_FORMAT_LEN_BIG_L
+}FLOG_FORMAT_LEN;
+
+/* 转换说明符 */
+typedef struct
+{
+    uint8_t flags;          /* 标志 */
+    FLOG_FORMAT_LEN len;    /* 长度修饰符 */
+    char conv;              /* 转换字符 */
+    int width;              /* 宽度 */
+    int precision;          /* 精度, -1表示未指定 */
+}flog_format_spec_t;
+
+/* 输出位置 */
+typedef struct
+{
+    char *buffer;   /* 目标缓冲区 */
+    uint32_t limit; /* 可写入的字符数, 不含结束符 */
+    uint32_t pos;   /* 完整输出需要的长度, 可能超过limit */
+}flog_format_out_t;
+
+static const uint32_t flog_format_pow10[FLOG_FORMAT_FRACTION_MAX + 1] =
+{
+    1U, 10U, 100U, 1000U, 10000U, 100000U, 1000000U, 10000000U, 100000000U, 1000000000U
+};
+
+/**
+ * @brief 写入字符串
+ * @param out 输出位置
+ * @param str 字符串
+ * @param len 长度
+ */
+static inline void flog_format_write(flog_format_out_t *out, const char *str, uint32_t len)
+{
+    if (out->pos + len <= out->limit)
+    {
+        /* 说明符的输出通常只有几个字符, 逐字节拷贝比调用memcpy快 */
+        char *dest = out->buffer + out->pos;
+        for (uint32_t i = 0; i < len; ++i)
+        {
+            dest[i] = str[i];
+        }
+    }
+    else if (out->pos < out->limit)
+    {
+        memcpy(out->buffer + out->pos, str, out->limit - out->pos);
+    }
+    out->pos += len;
+}
+
+/**
+ * @brief 写入重复字符
+ * @param out 输出位置
+ * @param c   字符
+ * @param num 数量
+ */
+static inline void flog_format_fill(flog_format_out_t *out, char c, uint32_t num)
+{
+    if (out->pos < out->limit)
+    {
+        uint32_t copy = out->limit - out->pos;
+        copy = copy < num ? copy : num;
+        for (uint32_t i = 0; i < copy; ++i)
+        {
+            out->buffer[out->pos + i] = c;
+        }
+    }
+    out->pos += num;
+}
+
+/**
+ * @brief 无符号数转字符串
+ * @param digits 目标位置, 至少FLOG_FORMAT_NUMBER_MAX字节
+ * @param value  数值
+ * @param base   进制, 8, 10或16
+ * @param upper  十六进制是否大写
+ * @return 写入长度
+ */
+static uint32_t flog_format_number(char *digits, unsigned long long value, uint32_t base, bool upper)
+{
+    const char *table = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    char temp[FLOG_FORMAT_NUMBER_MAX];
+    uint32_t pos = sizeof(temp);
+    if (base == 10)
+    {
+        if (value <= UINT32_MAX)
+        {
+            return flog_utoa(digits, (uint32_t)value);
+        }
+        do
+        {
+            temp[--pos] = (char)('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+    }
+    else
+    {
+        uint32_t shift = (base == 16) ? 4 : 3;
+        do
+        {
+            temp[--pos] = table[value & (base - 1)];
+            value >>= shift;
+        } while (value != 0);
+    }
+    memcpy(digits, temp + pos, sizeof(temp) - pos);
+    return sizeof(temp) - pos;
+}
+
+/**
+ * @brief 按宽度输出前缀和数字
+ * @param out    输出位置
+ * @param spec   转换说明符
+ * @param prefix 符号或进制前缀
+ * @param prefix_len 前缀长度
+ * @param zeros  精度要求的前导0数量
+ * @param digits 数字
+ * @param len    数字长度
+ */
+static void flog_format_pad(flog_format_out_t *out, const flog_format_spec_t *spec, const char *prefix, uint32_t prefix_len,
+                            uint32_t zeros, const char *digits, uint32_t len)
+{
+    uint32_t total = prefix_len + zeros + len;
+    uint32_t pad = (spec->width > 0 && (uint32_t)spec->width > total) ? (uint32_t)spec->width - total : 0;
+    if (!(spec->flags & FLOG_FORMAT_FLAG_LEFT))
+    {
+        if (spec->flags & FLOG_FORMAT_FLAG_ZERO)
+        {
+            zeros += pad;
+        }
+        else
+        {
+            flog_format_fill(out, ' ', pad);
+        }
+        pad = 0;
+    }
+    flog_format_write(out, prefix, prefix_len);
+    flog_format_fill(out, '0', zeros);
+    flog_format_write(out, digits, len);
+    flog_format_fill(out, ' ', pad);
+}
+
+/**
+ * @brief 输出整数
+ * @param out      输出位置
+ * @param spec     转换说明符
+ * @param value    绝对值
+ * @param negative 是否为负数
+ */
+static void flog_format_integer(flog_format_out_t *out, const flog_format_spec_t *spec, unsigned long long value, bool negative)
+{
+    char digits[FLOG_FORMAT_NUMBER_MAX];
+    char prefix[2];
+    uint32_t prefix_len = 0;
+    uint32_t len = 0;
+    uint32_t base = 10;
+    uint32_t zeros = 0;
+    if (spec->conv == 'x' || spec->conv == 'X' || spec->conv == 'p')
+        base = 16;
+    else if (spec->conv == 'o')
+        base = 8;
+
+    if (value != 0 || spec->precision != 0)
+    {
+        len = flog_format_number(digits, value, base, spec->conv == 'X');
+    }
+    if (negative)
+        prefix[prefix_len++] = '-';
+    else if ((spec->conv == 'd' || spec->conv == 'i') && (spec->flags & FLOG_FORMAT_FLAG_PLUS))
+        prefix[prefix_len++] = '+';
+    else if ((spec->conv == 'd' || spec->conv == 'i') && (spec->flags & FLOG_FORMAT_FLAG_SPACE))
+        prefix[prefix_len++] = ' ';
+    else if (spec->conv == 'p' || (base == 16 && value != 0 && (spec->flags & FLOG_FORMAT_FLAG_ALT)))
+    {
+        prefix[prefix_len++] = '0';
+        prefix[prefix_len++] = (spec->conv == 'X') ? 'X' : 'x';
+    }
+
+    if (spec->precision >= 0 && (uint32_t)spec->precision > len)
+        zeros = (uint32_t)spec->precision - len;
+    if (base == 8 && (spec->flags & FLOG_FORMAT_FLAG_ALT) && zeros == 0 && (len == 0 || digits[0] != '0'))
+        zeros = 1;
+    /* 指定精度时忽略'0'标志 */
+    if (spec->precision >= 0)
+    {
+        flog_format_spec_t temp = *spec;
+        temp.flags &= (uint8_t)~FLOG_FORMAT_FLAG_ZERO;
+        flog_format_pad(out, &temp, prefix, prefix_len, zeros, digits, len);
+        return;
+    }
+    flog_format_pad(out, spec, prefix, prefix_len, zeros, digits, len);
+}
+
+/**
+ * @brief 计算小数部分
+ * @note  按IEEE754双精度取出尾数, 在60位定点数上逐位乘10, 结果与精确值按向偶数舍入一致
+ * @param value   非负数值, 小于FLOG_FORMAT_FLOAT_LIMIT
+ * @param len     小数位数, 不超过FLOG_FORMAT_FRACTION_MAX
+ * @param odd     len为0时整数部分是否为奇数
+ * @param integer 整数部分, 进位时加1
+ * @return 小数部分的len位数字
+ */
+static uint32_t flog_format_fraction(double value, uint32_t len, bool odd, unsigned long long *integer)
+{
+    const unsigned long long one = 1ULL << 60;
+    unsigned long long bits;
+    unsigned long long frac = 0;
+    bool sticky = false;
+    memcpy(&bits, &value, sizeof(bits));
+    int exponent = (int)((bits >> 52) & 0x7FF);
+    unsigned long long mantissa = bits & ((1ULL << 52) - 1);
+    if (exponent != 0)
+    {
+        mantissa |= 1ULL << 52;
+    }
+    else
+    {
+        exponent = 1;
+    }
+    /* value = mantissa * 2^(exponent - 1075), 小数部分有shift位 */
+    int shift = 1075 - exponent;
+    if (shift <= 0)
+    {
+        return 0;
+    }
+    if (shift < 64)
+    {
+        mantissa &= (1ULL << shift) - 1;
+    }
+    if (shift <= 60)
+    {
+        frac = mantissa << (60 - shift);
+    }
+    else if (shift - 60 < 64)
+    {
+        frac = mantissa >> (shift - 60);
+        sticky = (mantissa & ((1ULL << (shift - 60)) - 1)) != 0;
+    }
+    else
+    {
+        sticky = (mantissa != 0);
+    }
+
+    uint32_t fraction = 0;
+    for (uint32_t i = 0; i < len; ++i)
+    {
+        frac *= 10;
+        fraction = fraction * 10 + (uint32_t)(frac >> 60);
+        frac &= one - 1;
+    }
+    if (frac > one / 2 || (frac == one / 2 && (sticky || (len ? (fraction & 1) : odd))))
+    {
+        if (++fraction >= flog_format_pow10[len])
+        {
+            fraction = 0;
+            (*integer)++;
+        }
+    }
+    return fraction;
+}
+
+/**
+ * @brief 输出浮点数
+ * @note  先把整数部分和9位以内的小数部分转为整数
+ * @param out   输出位置
+ * @param spec  转换说明符
+ * @param value 数值
+ */
+static void flog_format_float(flog_format_out_t *out, const flog_format_spec_t *spec, double value)
+{
+    char digits[FLOG_FORMAT_NUMBER_MAX + 1 + FLOG_FORMAT_FRACTION_MAX];
+    char prefix[1];
+    uint32_t prefix_len = 0;
+    uint32_t len = 0;
+    bool upper = (spec->conv >= 'A' && spec->conv <= 'Z');
+    uint32_t precision = (spec->precision < 0) ? 6 : (uint32_t)spec->precision;
+    uint32_t fraction_len = (precision > FLOG_FORMAT_FRACTION_MAX) ? FLOG_FORMAT_FRACTION_MAX : precision;
+    uint32_t scale = 0;
+    flog_format_spec_t temp = *spec;
+
+    if (value < 0 || (value == 0 && 1 / value < 0))
+    {
+        prefix[prefix_len++] = '-';
+        value = -value;
+    }
+    else if (spec->flags & FLOG_FORMAT_FLAG_PLUS)
+        prefix[prefix_len++] = '+';
+    else if (spec->flags & FLOG_FORMAT_FLAG_SPACE)
+        prefix[prefix_len++] = ' ';
+
+    if (value != value || value > 1.7976931348623157e308)
+    {
+        /* nan和inf不用0填充 */
+        temp.flags &= (uint8_t)~FLOG_FORMAT_FLAG_ZERO;
+        flog_format_pad(out, &temp, prefix, prefix_len, 0, (value != value) ? (upper ? "NAN" : "nan") : (upper ? "INF" : "inf"), 3);
+        return;
+    }
+
+    /* 整数部分超过64位时缩小, 末尾补0 */
+    while (value >= FLOG_FORMAT_FLOAT_LIMIT)
+    {
+        value /= 10;
+        scale++;
+    }
+    if (scale != 0)
+    {
+        fraction_len = 0;
+    }
+    unsigned long long integer = (unsigned long long)value;
+    uint32_t fraction = 0;
+    if (scale == 0)
+    {
+        fraction = flog_format_fraction(value, fraction_len, (fraction_len == 0) && (integer & 1), &integer);
+    }
+
+    len = flog_format_number(digits, integer, 10, false);
+    uint32_t tail = scale + precision - fraction_len;
+    if (precision > 0 || (spec->flags & FLOG_FORMAT_FLAG_ALT))
+    {
+        /* 缩小后的数只输出整数位, 小数点留到补0之后 */
+        if (scale == 0)
+        {
+            digits[len++] = '.';
+        }
+        else
+        {
+            tail++;
+        }
+    }
+    for (uint32_t i = fraction_len; i > 0; --i)
+    {
+        digits[len + i - 1] = (char)('0' + fraction % 10);
+        fraction /= 10;
+    }
+    len += fraction_len;
+
+    if (tail == 0)
+    {
+        flog_format_pad(out, spec, prefix, prefix_len, 0, digits, len);
+        return;
+    }
+    /* 超出计算范围的位数补0, 宽度按完整长度计算 */
+    uint32_t total = prefix_len + len + tail;
+    uint32_t pad = (spec->width > 0 && (uint32_t)spec->width > total) ? (uint32_t)spec->width - total : 0;
+    if (!(spec->flags & FLOG_FORMAT_FLAG_LEFT) && !(spec->flags & FLOG_FORMAT_FLAG_ZERO))
+        flog_format_fill(out, ' ', pad);
+    flog_format_write(out, prefix, prefix_len);
+    if (!(spec->flags & FLOG_FORMAT_FLAG_LEFT) && (spec->flags & FLOG_FORMAT_FLAG_ZERO))
+        flog_format_fill(out, '0', pad);
+    flog_format_write(out, digits, len);
+    if (scale != 0)
+    {
+        flog_format_fill(out, '0', scale);
+        if (tail > scale)
+        {
+            flog_format_write(out, ".", 1);
+            flog_format_fill(out, '0', tail - scale - 1);
+        }
+    }
+    else
+    {
+        flog_format_fill(out, '0', tail);
+    }
+    if (spec->flags & FLOG_FORMAT_FLAG_LEFT)
+        flog_format_fill(out, ' ', pad);
+}
+
+/**
+ * @brief 解析一个转换说明符
+ * @param fmt  指向'%'之后
+ * @param spec 输出说明符
+ * @param args 参数列表, 用于读取*宽度和精度
+ * @return 说明符之后的位置
+ */
+static const char *flog_format_parse(const char *fmt, flog_format_spec_t *spec, va_list *args)
+{
+    spec->flags = 0;
+    spec->width = 0;
+    spec->precision = -1;
+    spec->len = FLOG_FORMAT_LEN_NONE;
+    /* 标志 */
+    while (1)
+    {
+        if (*fmt == '-')
+            spec->flags |= FLOG_FORMAT_FLAG_LEFT;
+        else if (*fmt == '+')
+            spec->flags |= FLOG_FORMAT_FLAG_PLUS;
+        else if (*fmt == ' ')
+            spec->flags |= FLOG_FORMAT_FLAG_SPACE;
+        else if (*fmt == '#')
+            spec->flags |= FLOG_FORMAT_FLAG_ALT;
+        else if (*fmt == '0')
+            spec->flags |= FLOG_FORMAT_FLAG_ZERO;
+        else if (*fmt != '\'')
+            break;
+        fmt++;
+    }
+    /* 宽度 */
+    if (*fmt == '*')
+    {
+        spec->width = va_arg(*args, int);
+        if (spec->width < 0)
+        {
+            spec->flags |= FLOG_FORMAT_FLAG_LEFT;
+            spec->width = -spec->width;
+        }
+        fmt++;
+    }
+    else
+    {
+        while (*fmt >= '0' && *fmt <= '9')
+        {
+            spec->width = spec->width * 10 + (*fmt++ - '0');
+        }
+    }
+    /* 精度 */
+    if (*fmt == '.')
+    {
+        fmt++;
+        spec->precision = 0;
+        if (*fmt == '*')
+        {
+            spec->precision = va_arg(*args, int);
+            if (spec->precision < 0)
+                spec->precision = -1;
+            fmt++;
+        }
+        else
+        {
+            while (*fmt >= '0' && *fmt <= '9')
+            {
+                spec->precision = spec->precision * 10 + (*fmt++ - '0');
+            }
+        }
+    }
+    /* 长度 */
+    switch (*fmt)
+    {
+        case 'h':
+            spec->len = (fmt[1] == 'h') ? FLOG_FORMAT_LEN_HH : FLOG_FORMAT_LEN_H;
+            fmt += (fmt[1] == 'h') ? 2 : 1;
+            break;
+        case 'l':
+            spec->len = (fmt[1] == 'l') ? FLOG_FORMAT_LEN_LL : FLOG_FORMAT_LEN_L;
+            fmt += (fmt[1] == 'l') ? 2 : 1;
+            break;
+        case 'j': spec->len = FLOG_FORMAT_LEN_J; fmt++; break;
+        case 'z': spec->len = FLOG_FORMAT_LEN_Z; fmt++; break;
+        case 't': spec->len = FLOG_FORMAT_LEN_T; fmt++; break;
+        case 'L': spec->len = FLOG_FORMAT_LEN_BIG_L; fmt++; break;
+        default: break;
+    }
+    spec->conv = *fmt;
+    return (*fmt) ? fmt + 1 : fmt;
+}
+
+/**
+ * @brief 格式化到缓冲区, 行为与vsnprintf相同
+ * @note  输出超过size时截断, size不为0时总是添加结束符
+ * @param buffer 目标缓冲区
+ * @param size 缓冲区大小, 含结束符
+ * @param fmt 格式
+ * @param args 参数列表
+ * @return 完整输出需要的长度, 不含结束符
+ */
+int flog_vformat(char *buffer, uint32_t size, const char *fmt, va_list args)
+{
+    flexlog_assert(fmt != NULL)
+    flexlog_assert(buffer != NULL || size == 0)
+    flog_format_out_t out = {buffer, size ? size - 1 : 0, 0};
+    flog_format_spec_t spec;
+    va_list list;
+    va_copy(list, args);
+    while (*fmt)
+    {
+        /* 普通字符整段拷贝 */
+        const char *start = fmt;
+        while (*fmt && *fmt != '%')
+        {
+            fmt++;
+        }
+        if (fmt != start)
+        {
+            flog_format_write(&out, start, (uint32_t)(fmt - start));
+            continue;
+        }
+
+        start = fmt;
+        fmt = flog_format_parse(fmt + 1, &spec, &list);
+        switch (spec.conv)
+        {
+            case 'd':
+            case 'i':
+            {
+                long long value;
+                switch (spec.len)
+                {
+                    case FLOG_FORMAT_LEN_HH: value = (signed char)va_arg(list, int); break;
+                    case FLOG_FORMAT_LEN_H:  value = (short)va_arg(list, int); break;
+                    case FLOG_FORMAT_LEN_L:  value = va_arg(list, long); break;
+                    case FLOG_FORMAT_LEN_LL: value = va_arg(list, long long); break;
+                    case FLOG_FORMAT_LEN_J:  value = va_arg(list, intmax_t); break;
+                    case FLOG_FORMAT_LEN_Z:
+                    case FLOG_FORMAT_LEN_T:  value = va_arg(list, ptrdiff_t); break;
+                    default:                 value = va_arg(list, int); break;
+                }
+                flog_format_integer(&out, &spec, (value < 0) ? 0ULL - (unsigned long long)value : (unsigned long long)value, value < 0);
+                break;
+            }
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X':
+            {
+                unsigned long long value;
+                switch (spec.len)
+                {
+                    case FLOG_FORMAT_LEN_HH: value = (unsigned char)va_arg(list, unsigned int); break;
+                    case FLOG_FORMAT_LEN_H:  value = (unsigned short)va_arg(list, unsigned int); break;
+                    case FLOG_FORMAT_LEN_L:  value = va_arg(list, unsigned long); break;
+                    case FLOG_FORMAT_LEN_LL: value = va_arg(list, unsigned long long); break;
+                    case FLOG_FORMAT_LEN_J:  value = va_arg(list, uintmax_t); break;
+                    case FLOG_FORMAT_LEN_Z:  value = va_arg(list, size_t); break;
+                    case FLOG_FORMAT_LEN_T:  value = (size_t)va_arg(list, ptrdiff_t); break;
+                    default:                 value = va_arg(list, unsigned int); break;
+                }
+                flog_format_integer(&out, &spec, value, false);
+                break;
+            }
+            case 'p':
+                flog_format_integer(&out, &spec, (uintptr_t)va_arg(list, void *), false);
+                break;
+            case 'c':
+            {
+                if (spec.len == FLOG_FORMAT_LEN_L)
+                {
+                    /* 宽字符不支持, 读取参数后原样输出说明符 */
+                    (void)va_arg(list, int);
+                    flog_format_write(&out, start, (uint32_t)(fmt - start));
+                    break;
+                }
+                char c = (char)va_arg(list, int);
+                spec.flags &= (uint8_t)~FLOG_FORMAT_FLAG_ZERO;
+                flog_format_pad(&out, &spec, "", 0, 0, &c, 1);
+                break;
+            }
+            case 's':
+            {
+                const char *str = va_arg(list, const char *);
+                if (spec.len == FLOG_FORMAT_LEN_L)
+                {
+                    flog_format_write(&out, start, (uint32_t)(fmt - start));
+                    break;
+                }
+                uint32_t len = 0;
+                if (str == NULL)
+                {
+                    str = "(null)";
+                }
+                while ((spec.precision < 0 || len < (uint32_t)spec.precision) && str[len])
+                {
+                    len++;
+                }
+                spec.flags &= (uint8_t)~FLOG_FORMAT_FLAG_ZERO;
+                flog_format_pad(&out, &spec, "", 0, 0, str, len);
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A':
+                if (spec.len == FLOG_FORMAT_LEN_BIG_L)
+                    flog_format_float(&out, &spec, (double)va_arg(list, long double));
+                else
+                    flog_format_float(&out, &spec, va_arg(list, double));
+                break;
+            case '%':
+                flog_format_write(&out, "%", 1);
+                break;
+            default:
+                /* 不支持的说明符原样输出, 不读取参数 */
+                flog_format_write(&out, start, (uint32_t)(fmt - start));
+                break;
+        }
+    }
+    va_end(list);
+    if (size)
+    {
+        buffer[(out.pos < out.limit) ? out.pos : out.limit] = '\0';
+    }
+    return (int)out.pos;
+}
+
+/**
+ * @brief 格式化到缓冲区, 行为与snprintf相同
+ * @param buffer 目标缓冲区
+ * @param size 缓冲区大小, 含结束符
+ * @param fmt 格式
+ * @param ... 参数
+ * @return 完整输出需要的长度, 不含结束符
+ */
+int flog_format(char *buffer, uint32_t size, const char *fmt, ...)
+{
+    va_list args;
+    va_start(args, fmt);
+    int ret = flog_vformat(buffer, size, fmt, args);
+    va_end(args);
+    return ret;
+}
+#endif // FLEXILOG_USE_BUILTIN_FORMAT
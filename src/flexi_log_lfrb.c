@@ -0,0 +1,232 @@
+/**
+ * ==================================================
+ *  @file flexi_log_lfrb.c
+ *  @brief flexi log 无锁多生产者环形缓冲区实现文件
+ *  @note  每条日志保存为一条记录: [位置][长度][校验][数据], 按4字节对齐
+ *  @note  写入者先淘汰重叠的已提交记录, 再通过CAS预留空间, 拷贝数据后写入记录位置作为提交标志
+ *  @note  最旧的记录未提交时最多让出FLEXILOG_LFRB_YIELD_LIMIT次CPU, 超时丢弃新日志并计数
+ *  @note  等待依赖其他写入者被调度, 不能在中断中写入
+ *  @note  读取者只会读到已提交的记录, 读取过程中记录被覆盖时会丢弃本次拷贝
+ *  @author GYM (48060945@qq.com)
+ *  @date 2025-11-16 下午8:30
+ *  @version 1.0
+ *  @copyright Copyright (c) 2025 GYM. All Rights Reserved.
+ * ==================================================
+ */
+
+
+#include "flexi_log_lfrb.h"
+#include "flexi_log.h"
+#ifdef FLEXILOG_USE_LOCK_FREE_RING_BUFFER
+#include "string.h"
+#include "stdint.h"
+
+#define FLOG_LFRB_HEAD_SIZE         12                                  /* 记录头大小 */
+#define FLOG_LFRB_ALIGN(size)       (((size) + 3u) & ~3u)               /* 记录按4字节对齐 */
+#define FLOG_LFRB_CHECK(pos, len)   ((pos) ^ (len) ^ 0x5AA5C33Cu)       /* 记录头校验 */
+
+/* flexi_log_port */
+extern void flog_port_yield(void);
+
+/**
+ * @brief 初始化环形缓冲区
+ * @note  缓冲区会按4字节对齐, 大小向下取整为2的幂
+ * @param rb 环形缓冲区
+ * @param buffer 数据缓冲区
+ * @param size 数据缓冲区大小
+ */
+void flog_lfrb_init(flog_lfrb_t *rb, char *buffer, uint32_t size)
+{
+    flexlog_assert(rb);
+    flexlog_assert(buffer);
+    uint32_t offset = (uint32_t)((4 - ((uintptr_t)buffer & 3u)) & 3u);
+    flexlog_assert(size >= offset + 2 * FLOG_LFRB_HEAD_SIZE);
+    uint32_t rb_size = 1;
+    while (rb_size <= (size - offset) / 2)
+    {
+        rb_size <<= 1;
+    }
+    memset(buffer + offset, 0, rb_size);
+    rb->buffer = buffer + offset;
+    rb->size = rb_size;
+    rb->mask = rb_size - 1;
+    atomic_init(&rb->write_pos, 0);
+    atomic_init(&rb->read_pos, 0);
+    atomic_init(&rb->drop_count, 0);
+}
+
+#ifdef FLEXILOG_AUTO_MALLOC
+extern void *flog_port_malloc(size_t size);
+/**
+ * @brief 创建一个缓冲区
+ * @param rb 环形缓冲区
+ * @param size 缓冲区大小
+ */
+void flog_lfrb_buffer_create(flog_lfrb_t *rb, uint32_t size)
+{
+    flexlog_assert(rb != NULL);
+    char *buffer = flog_port_malloc(size);
+    if (buffer != NULL)
+    {
+        flog_lfrb_init(rb, buffer, size);
+    }
+}
+#endif //FLEXILOG_AUTO_MALLOC
+
+/**
+ * @brief 获取记录头中的字
+ * @param rb 环形缓冲区
+ * @param pos 位置
+ * @return 原子字
+ */
+static _Atomic uint32_t *flog_lfrb_word(flog_lfrb_t *rb, uint32_t pos)
+{
+    return (_Atomic uint32_t *)(rb->buffer + (pos & rb->mask));
+}
+
+/**
+ * @brief 获取已提交记录的大小
+ * @param rb 环形缓冲区
+ * @param pos 记录位置
+ * @param len 输出数据长度
+ * @return 记录占用的空间大小, 0表示记录未提交
+ */
+static uint32_t flog_lfrb_committed_size(flog_lfrb_t *rb, uint32_t pos, uint32_t *len)
+{
+    if (atomic_load_explicit(flog_lfrb_word(rb, pos), memory_order_acquire) != pos)
+    {
+        return 0;
+    }
+    *len = atomic_load_explicit(flog_lfrb_word(rb, pos + 4), memory_order_relaxed);
+    if (atomic_load_explicit(flog_lfrb_word(rb, pos + 8), memory_order_relaxed) != FLOG_LFRB_CHECK(pos, *len)
+        || *len > rb->size - FLOG_LFRB_HEAD_SIZE)
+    {
+        return 0;
+    }
+    return FLOG_LFRB_ALIGN(FLOG_LFRB_HEAD_SIZE + *len);
+}
+
+/**
+ * @brief 读取整行数据
+ * @note  只能有一个读取者, 可以和多个写入者同时进行
+ * @param rb 环形缓冲区
+ * @param data 数据缓冲区
+ * @param size 数据缓冲区大小
+ * @return 读取的字节大小
+ */
+uint32_t flog_lfrb_read_lines(flog_lfrb_t *rb, char *data, uint32_t size)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flexlog_assert(data);
+    uint32_t read_size = 0;
+    uint32_t len = 0;
+    uint32_t record_size = 0;
+    uint32_t index = 0;
+    uint32_t first = 0;
+    uint32_t read_pos = atomic_load_explicit(&rb->read_pos, memory_order_acquire);
+    while (read_pos != atomic_load_explicit(&rb->write_pos, memory_order_acquire))
+    {
+        record_size = flog_lfrb_committed_size(rb, read_pos, &len);
+        if (record_size == 0 || read_size + len > size)
+        {
+            break;
+        }
+        index = (read_pos + FLOG_LFRB_HEAD_SIZE) & rb->mask;
+        first = (rb->size - index < len) ? (rb->size - index) : len;
+        memcpy(data + read_size, rb->buffer + index, first);
+        memcpy(data + read_size + first, rb->buffer, len - first);
+        /* 拷贝期间记录没有被淘汰才算读取成功, 否则read_pos会被更新为最新位置 */
+        if (atomic_compare_exchange_strong_explicit(&rb->read_pos, &read_pos, read_pos + record_size,
+                                                    memory_order_acq_rel, memory_order_acquire))
+        {
+            read_size += len;
+            read_pos += record_size;
+        }
+    }
+    return read_size;
+}
+
+/**
+ * @brief 强制写入数据
+ * @note  可以多个写入者同时写入, 空间不足时淘汰最旧的整条记录
+ * @note  最旧的记录还在写入中时让出CPU等待, 超过FLEXILOG_LFRB_YIELD_LIMIT次后丢弃本条日志
+ * @note  不能在中断中调用, 被中断的写入者无法在中断返回前提交
+ * @param rb 环形缓冲区
+ * @param data 数据缓冲区
+ * @param size 数据缓冲区大小
+ * @return 是否写入成功
+ */
+bool flog_lfrb_write_force(flog_lfrb_t *rb, const char *data, uint32_t size)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flexlog_assert(data);
+    if (size > rb->size - FLOG_LFRB_HEAD_SIZE)
+    {
+        size = rb->size - FLOG_LFRB_HEAD_SIZE;
+    }
+    const uint32_t total_size = FLOG_LFRB_ALIGN(FLOG_LFRB_HEAD_SIZE + size);
+    uint32_t pos = atomic_load_explicit(&rb->write_pos, memory_order_relaxed);
+    uint32_t read_pos = atomic_load_explicit(&rb->read_pos, memory_order_acquire);
+    uint32_t record_size = 0;
+    uint32_t len = 0;
+    uint32_t yield_count = 0;
+
+    /* 先淘汰与预留空间重叠的记录再预留, 超时放弃时没有占用任何空间 */
+    while (1)
+    {
+        if (pos + total_size - read_pos <= rb->size)
+        {
+            if (atomic_compare_exchange_weak_explicit(&rb->write_pos, &pos, pos + total_size,
+                                                      memory_order_relaxed, memory_order_relaxed))
+            {
+                break;
+            }
+            read_pos = atomic_load_explicit(&rb->read_pos, memory_order_acquire);
+            continue;
+        }
+        record_size = flog_lfrb_committed_size(rb, read_pos, &len);
+        if (record_size == 0)
+        {
+            /* 最旧的记录还在写入中, 让出CPU等待写入者提交 */
+            if (++yield_count > FLEXILOG_LFRB_YIELD_LIMIT)
+            {
+                atomic_fetch_add_explicit(&rb->drop_count, 1, memory_order_relaxed);
+                return false;
+            }
+            flog_port_yield();
+            read_pos = atomic_load_explicit(&rb->read_pos, memory_order_acquire);
+        }
+        else if (atomic_compare_exchange_weak_explicit(&rb->read_pos, &read_pos, read_pos + record_size,
+                                                       memory_order_acq_rel, memory_order_acquire))
+        {
+            read_pos += record_size;
+        }
+        pos = atomic_load_explicit(&rb->write_pos, memory_order_relaxed);
+    }
+
+    /* 拷贝数据 */
+    uint32_t index = (pos + FLOG_LFRB_HEAD_SIZE) & rb->mask;
+    uint32_t first = (rb->size - index < size) ? (rb->size - index) : size;
+    atomic_store_explicit(flog_lfrb_word(rb, pos + 4), size, memory_order_relaxed);
+    atomic_store_explicit(flog_lfrb_word(rb, pos + 8), FLOG_LFRB_CHECK(pos, size), memory_order_relaxed);
+    memcpy(rb->buffer + index, data, first);
+    memcpy(rb->buffer, data + first, size - first);
+
+    /* 提交 */
+    atomic_store_explicit(flog_lfrb_word(rb, pos), pos, memory_order_release);
+    return true;
+}
+
+/**
+ * @brief 获取丢弃的日志数量
+ * @param rb 环形缓冲区
+ * @return 等待超时丢弃的日志数量
+ */
+uint32_t flog_lfrb_get_drop_count(flog_lfrb_t *rb)
+{
+    flexlog_assert(rb);
+    return atomic_load_explicit(&rb->drop_count, memory_order_relaxed);
+}
+#endif // FLEXILOG_USE_LOCK_FREE_RING_BUFFER
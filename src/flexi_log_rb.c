@@ -12,22 +12,108 @@
 
 #include "flexi_log_rb.h"
 #include "flexi_log.h"
-#ifdef FLEXILOG_USE_RING_BUFFER
+#if defined(FLEXILOG_USE_RING_BUFFER) || defined(FLEXILOG_USE_ASYNC_OUTPUT)
 #include "stdbool.h"
 #include "string.h"
 #include "stdint.h"
 
 
+#if defined(FLEXILOG_USE_ZERO_COPY_RING_BUFFER) && defined(FLEXILOG_USE_FRAMED_RING_BUFFER)
+#define FLOG_RB_RESERVE_BOUND_MAX 32    /* 预留空间最多覆盖的旧记录数, 超过时不预留, 必须是2的幂 */
+
 /**
- * @brief 初始化环形缓冲区
+ * @brief 预留记录时最旧记录的边界缓存
+ * @note  按顺序保存读指针之后连续记录的结束位置, 下一行预留时只需要从最后一个边界继续查找
+ * @note  边界是相对base的位置, 读指针移动时base随之增加, 只移出已经丢弃的边界; 调用者持有日志锁
+ */
+static struct
+{
+    flog_ring_buffer_t *rb;
+    uint32_t base;
+    uint32_t first;
+    uint32_t num;
+    uint32_t bound[FLOG_RB_RESERVE_BOUND_MAX];
+}flog_rb_reserve_cache;
+
+#define flog_rb_reserve_bound(i)    (flog_rb_reserve_cache.bound[(flog_rb_reserve_cache.first + (i)) % FLOG_RB_RESERVE_BOUND_MAX] - flog_rb_reserve_cache.base)
+
+/**
+ * @brief 读指针移动后更新边界缓存
+ * @note  移动到某条记录的边界时保留之后的边界, 停在记录中间时清空缓存
+ * @param step 读指针移动的大小, UINT32_MAX表示丢弃全部数据
+ */
+static void flog_rb_reserve_shift(uint32_t step)
+{
+    uint32_t end = 0;
+    while (flog_rb_reserve_cache.num > 0 && flog_rb_reserve_bound(0) <= step)
+    {
+        end = flog_rb_reserve_bound(0);
+        flog_rb_reserve_cache.first = (flog_rb_reserve_cache.first + 1) % FLOG_RB_RESERVE_BOUND_MAX;
+        flog_rb_reserve_cache.num--;
+    }
+    if (flog_rb_reserve_cache.num > 0 && end != step)
+    {
+        flog_rb_reserve_cache.num = 0;
+    }
+    flog_rb_reserve_cache.base += step;
+}
+
+#define flog_rb_read_moved(rb, step)    ((rb) == flog_rb_reserve_cache.rb ? flog_rb_reserve_shift(step) : (void)0)
+#else
+#define flog_rb_read_moved(rb, step)    ((void)0)
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER && FLEXILOG_USE_FRAMED_RING_BUFFER
+
+#ifdef FLEXILOG_USE_POW2_RING_BUFFER
+/**
+ * @brief 复位环形缓冲区
+ * @note  缓冲区大小向下取整为2的幂
  * @param rb 环形缓冲区
  * @param buffer 数据缓冲区
  * @param size 数据缓冲区大小
  */
-void flog_rb_init(flog_ring_buffer_t *rb, char *buffer, uint32_t size)
+static void flog_rb_reset(flog_ring_buffer_t *rb, char *buffer, uint32_t size)
+{
+    uint32_t rb_size = 1;
+    while (rb_size <= size / 2)
+    {
+        rb_size <<= 1;
+    }
+    memset(buffer, 0, rb_size);
+    rb->buffer = buffer;
+    rb->size = rb_size;
+    rb->mask = rb_size - 1;
+    rb->read_pos = 0;
+    rb->write_pos = 0;
+    flog_rb_read_moved(rb, UINT32_MAX);
+}
+
+/* 读写指针自由增长, 差值即为已使用大小 */
+#define flog_rb_read_index(rb)          ((rb)->read_pos & (rb)->mask)
+#define flog_rb_index_at(rb, offset)    (((rb)->read_pos + (offset)) & (rb)->mask)
+#define flog_rb_write_index(rb)         ((rb)->write_pos & (rb)->mask)
+#define flog_rb_write_index_at(rb, offset)  (((rb)->write_pos + (offset)) & (rb)->mask)
+#define flog_rb_read_skip(rb, step)     ((rb)->read_pos += (step), flog_rb_read_moved(rb, step))
+#define flog_rb_write_skip(rb, step)    ((rb)->write_pos += (step))
+#define flog_rb_clear(rb)               ((rb)->read_pos = (rb)->write_pos, flog_rb_read_moved(rb, UINT32_MAX))
+
+/**
+ * @brief 获取已使用的空间
+ * @param rb 环形缓冲区
+ * @return 已写入未读取的字节大小
+ */
+uint32_t flog_rb_get_used(flog_ring_buffer_t *rb)
+{
+    return rb->write_pos - rb->read_pos;
+}
+#else
+/**
+ * @brief 复位环形缓冲区
+ * @param rb 环形缓冲区
+ * @param buffer 数据缓冲区
+ * @param size 数据缓冲区大小
+ */
+static void flog_rb_reset(flog_ring_buffer_t *rb, char *buffer, uint32_t size)
 {
-    flexlog_assert(rb);
-    flexlog_assert(buffer);
     memset(buffer, 0, size);
     rb->buffer = buffer;
     rb->size = size;
@@ -35,6 +121,94 @@ void flog_rb_init(flog_ring_buffer_t *rb, char *buffer, uint32_t size)
     rb->write_pos = 0;
     rb->read_pos_mirror = 0;
     rb->write_pos_mirror = 0;
+    flog_rb_read_moved(rb, UINT32_MAX);
+}
+
+/**
+ * @brief 指针前进
+ * @param pos 当前位置
+ * @param step 前进的字节大小
+ * @param size 缓冲区大小
+ * @param mirror 镜像位, 跨越奇数次缓冲区末尾时翻转
+ * @return 新位置
+ */
+static uint32_t flog_rb_advance(uint32_t pos, uint32_t step, uint32_t size, uint32_t *mirror)
+{
+    uint64_t end = (uint64_t)pos + step;
+    if ((end / size) & 1)
+    {
+        *mirror = !*mirror;
+    }
+    return (uint32_t)(end % size);
+}
+
+/**
+ * @brief 读指针前进
+ * @param rb 环形缓冲区
+ * @param step 前进的字节大小
+ */
+static void flog_rb_read_skip(flog_ring_buffer_t *rb, uint32_t step)
+{
+    uint32_t mirror = rb->read_pos_mirror;
+    rb->read_pos = flog_rb_advance(rb->read_pos, step, rb->size, &mirror);
+    rb->read_pos_mirror = mirror;
+    flog_rb_read_moved(rb, step);
+}
+
+/**
+ * @brief 写指针前进
+ * @param rb 环形缓冲区
+ * @param step 前进的字节大小
+ */
+static void flog_rb_write_skip(flog_ring_buffer_t *rb, uint32_t step)
+{
+    uint32_t mirror = rb->write_pos_mirror;
+    rb->write_pos = flog_rb_advance(rb->write_pos, step, rb->size, &mirror);
+    rb->write_pos_mirror = mirror;
+}
+
+/**
+ * @brief 丢弃所有未读取的数据
+ * @param rb 环形缓冲区
+ */
+static void flog_rb_clear(flog_ring_buffer_t *rb)
+{
+    rb->read_pos = rb->write_pos;
+    rb->read_pos_mirror = rb->write_pos_mirror;
+    flog_rb_read_moved(rb, UINT32_MAX);
+}
+
+#define flog_rb_read_index(rb)          ((rb)->read_pos)
+#define flog_rb_index_at(rb, offset)    (((rb)->read_pos + (offset)) % (rb)->size)
+#define flog_rb_write_index(rb)         ((rb)->write_pos)
+#define flog_rb_write_index_at(rb, offset)  (((rb)->write_pos + (offset)) % (rb)->size)
+
+/**
+ * @brief 获取已使用的空间
+ * @param rb 环形缓冲区
+ * @return 已写入未读取的字节大小
+ */
+uint32_t flog_rb_get_used(flog_ring_buffer_t *rb)
+{
+    if (rb->read_pos == rb->write_pos)
+    {
+        return (rb->read_pos_mirror == rb->write_pos_mirror) ? 0 : rb->size;
+    }
+    return (rb->write_pos + rb->size - rb->read_pos) % rb->size;
+}
+#endif // FLEXILOG_USE_POW2_RING_BUFFER
+
+/**
+ * @brief 初始化环形缓冲区
+ * @param rb 环形缓冲区
+ * @param buffer 数据缓冲区
+ * @param size 数据缓冲区大小
+ */
+void flog_rb_init(flog_ring_buffer_t *rb, char *buffer, uint32_t size)
+{
+    flexlog_assert(rb);
+    flexlog_assert(buffer);
+    flog_rb_reset(rb, buffer, size);
 }
 
 #ifdef FLEXILOG_AUTO_MALLOC
@@ -48,39 +222,43 @@ extern void flog_port_free(void *ptr);
 void flog_rb_buffer_create(flog_ring_buffer_t *rb, uint32_t size)
 {
     flexlog_assert(rb != NULL)
-    rb->buffer = flog_port_malloc(size);
-    if (rb->buffer != NULL)
+    char *buffer = flog_port_malloc(size);
+    rb->buffer = buffer;
+    if (buffer != NULL)
     {
-        memset(rb->buffer, 0, size);
-        rb->size = size;
-        rb->read_pos = 0;
-        rb->write_pos = 0;
-        rb->read_pos_mirror = 0;
-        rb->write_pos_mirror = 0;
+        flog_rb_reset(rb, buffer, size);
     }
 }
 #endif //FLEXILOG_AUTO_MALLOC
 
 /**
- * @brief 判断缓冲区是否为空
+ * @brief 获取剩余空间
  * @param rb 环形缓冲区
- * @return true 空
- * @return false 非空
+ * @return 可写入的字节大小
  */
-static bool flog_rb_is_empty(flog_ring_buffer_t *rb)
+uint32_t flog_rb_get_free(flog_ring_buffer_t *rb)
 {
-    return (rb->read_pos == rb->write_pos && rb->read_pos_mirror == rb->write_pos_mirror);
+    return rb->size - flog_rb_get_used(rb);
 }
 
 /**
- * @brief 判断缓冲区是否已满
+ * @brief 拷贝数据但不移动读指针
  * @param rb 环形缓冲区
- * @return true 已满
- * @return false 未满
+ * @param offset 相对读指针的偏移
+ * @param data 数据缓冲区
+ * @param size 拷贝的字节大小, offset + size不能超过已使用大小
  */
-static bool flog_rb_is_full(flog_ring_buffer_t *rb)
+static void flog_rb_peek(flog_ring_buffer_t *rb, uint32_t offset, char *data, uint32_t size)
 {
-    return (rb->read_pos == rb->write_pos && rb->read_pos_mirror != rb->write_pos_mirror);
+    /* 最多分两段拷贝 */
+    uint32_t index = flog_rb_index_at(rb, offset);
+    uint32_t first = rb->size - index;
+    if (first > size)
+    {
+        first = size;
+    }
+    memcpy(data, &rb->buffer[index], first);
+    memcpy(data + first, rb->buffer, size - first);
 }
 
 /**
@@ -90,29 +268,19 @@ static bool flog_rb_is_full(flog_ring_buffer_t *rb)
  * @param size 数据缓冲区大小
  * @return 读取的字节大小
  */
-static uint32_t flog_rb_read(flog_ring_buffer_t *rb, char *data, uint32_t size)
+uint32_t flog_rb_read(flog_ring_buffer_t *rb, char *data, uint32_t size)
 {
-    if (flog_rb_is_empty(rb))
+    uint32_t used = flog_rb_get_used(rb);
+    if (size > used)
     {
-        return 0;
+        size = used;
     }
-
-    for (uint32_t i = 0; i < size; ++i)
+    if (size == 0)
     {
-        if(flog_rb_is_empty(rb))
-        {
-            return i;
-        }
-        else
-        {
-            data[i] = rb->buffer[rb->read_pos];
-            rb->read_pos = (rb->read_pos + 1) % rb->size;
-            if (rb->read_pos == 0)
-            {
-                rb->read_pos_mirror = !rb->read_pos_mirror;
-            }
-        }
+        return 0;
     }
+    flog_rb_peek(rb, 0, data, size);
+    flog_rb_read_skip(rb, size);
     return size;
 }
 
@@ -128,11 +296,11 @@ uint32_t flog_rb_read_lines(flog_ring_buffer_t *rb, char *data, uint32_t size)
     flexlog_assert(rb)
     flexlog_assert(rb->buffer)
     flexlog_assert(data);
-    if (flog_rb_is_empty(rb))
+    const uint32_t used = flog_rb_get_used(rb);  //已使用大小 做判断
+    if (used == 0)
         return 0;
-    const uint32_t write_pos_cur = rb->write_pos;//写入指针 做判断
     const uint32_t rb_size = rb->size;          //缓冲区大小
-    uint32_t try_read_pos = rb->read_pos;      //临时读取指针
+    uint32_t try_read_pos = flog_rb_read_index(rb);  //临时读取指针
     uint32_t read_szie = 0;     //读取大小
     uint32_t try_read_size = 0; //尝试读取大小
     char rChar = 0;             //读取字符
@@ -141,7 +309,10 @@ uint32_t flog_rb_read_lines(flog_ring_buffer_t *rb, char *data, uint32_t size)
         /*读取字符*/
         rChar = rb->buffer[try_read_pos];
         try_read_size++;
-        try_read_pos = (try_read_pos + 1) % rb_size;
+        if (++try_read_pos == rb_size)
+        {
+            try_read_pos = 0;
+        }
 
         /*判断是否超大小*/
         if(try_read_size >= size)
@@ -150,7 +321,7 @@ uint32_t flog_rb_read_lines(flog_ring_buffer_t *rb, char *data, uint32_t size)
         }
 
         /*缓冲区是否读取完毕*/
-        if (try_read_pos == write_pos_cur)
+        if (try_read_size == used)
         {
             read_szie = try_read_size;          //进这里说明缓冲区已经读取完最后一行并且没有超大小
             break;
@@ -165,8 +336,39 @@ uint32_t flog_rb_read_lines(flog_ring_buffer_t *rb, char *data, uint32_t size)
     return read_szie;
 }
 
+/**
+ * @brief 丢弃最旧的整行数据
+ * @note  至少丢弃size字节, 并继续丢弃到行尾, 避免残留半行数据
+ * @param rb 环形缓冲区
+ * @param size 需要丢弃的字节大小
+ */
+void flog_rb_drop_lines(flog_ring_buffer_t *rb, uint32_t size)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    const uint32_t used = flog_rb_get_used(rb);
+    uint32_t index = flog_rb_read_index(rb);
+    uint32_t drop_size = 0;
+    char rChar = 0;
+    while (drop_size < used)
+    {
+        rChar = rb->buffer[index];
+        if (++index == rb->size)
+        {
+            index = 0;
+        }
+        drop_size++;
+        if (drop_size >= size && rChar == '\n')
+        {
+            break;
+        }
+    }
+    flog_rb_read_skip(rb, drop_size);
+}
+
 /**
  * @brief 强制写入数据
+ * @note  空间不足时覆盖最旧的数据
  * @param rb 环形缓冲区
  * @param data 数据缓冲区
  * @param size 数据缓冲区大小
@@ -176,23 +378,368 @@ void flog_rb_write_force(flog_ring_buffer_t *rb, const char *data, uint32_t size
     flexlog_assert(rb);
     flexlog_assert(rb->buffer);
     flexlog_assert(data);
-    for (uint32_t i = 0; i < size; ++i)
+    if (size == 0)
+    {
+        return;
+    }
+
+    if (size >= rb->size)
+    {
+        /* 只有最后size字节会保留, 写完后缓冲区为满 */
+        flog_rb_write_skip(rb, size - rb->size);
+        data += size - rb->size;
+        size = rb->size;
+        flog_rb_clear(rb);
+    }
+    else
     {
-        if (flog_rb_is_full(rb))
+        /* 一次性丢弃最旧的数据 */
+        uint32_t free = flog_rb_get_free(rb);
+        if (size > free)
         {
-            rb->read_pos = (rb->read_pos + 1) % rb->size;
-            rb->buffer[rb->write_pos] = data[i];
-            rb->write_pos = (rb->write_pos + 1) % rb->size;
+            flog_rb_read_skip(rb, size - free);
         }
-        else
+    }
+
+    /* 最多分两段拷贝 */
+    uint32_t index = flog_rb_write_index(rb);
+    uint32_t first = rb->size - index;
+    if (first > size)
+    {
+        first = size;
+    }
+    memcpy(&rb->buffer[index], data, first);
+    memcpy(rb->buffer, data + first, size - first);
+    flog_rb_write_skip(rb, size);
+}
+
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+/**
+ * @brief 获取从指定下标开始的写入空间
+ * @param rb 环形缓冲区
+ * @param index 起始下标
+ * @param size 空间大小, 不能超过缓冲区大小
+ * @param span 返回的空间
+ * @return 空间段数
+ */
+static uint32_t flog_rb_span(flog_ring_buffer_t *rb, uint32_t index, uint32_t size, flog_rb_span_t span[2])
+{
+    uint32_t first = rb->size - index;
+    if (first > size)
+    {
+        first = size;
+    }
+    span[0].data = &rb->buffer[index];
+    span[0].size = first;
+    span[1].data = rb->buffer;
+    span[1].size = size - first;
+    return (span[1].size != 0) ? 2 : (first != 0);
+}
+
+/**
+ * @brief 预留写入空间
+ * @note  预留的空间可能覆盖最旧的数据, 预留到提交期间不能读取缓冲区, 调用者需要持有日志锁
+ * @param rb 环形缓冲区
+ * @param size 需要的字节大小, 超过缓冲区大小时按缓冲区大小预留
+ * @param span 返回的空间, 最多两段, 按顺序写入
+ * @return 空间段数
+ */
+uint32_t flog_rb_reserve(flog_ring_buffer_t *rb, uint32_t size, flog_rb_span_t span[2])
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flexlog_assert(span);
+    if (size > rb->size)
+    {
+        size = rb->size;
+    }
+    return flog_rb_span(rb, flog_rb_write_index(rb), size, span);
+}
+
+/**
+ * @brief 提交预留的空间
+ * @note  空间不足时覆盖最旧的数据, 与flog_rb_write_force一致
+ * @param rb 环形缓冲区
+ * @param size 实际写入的字节大小, 不能超过预留的大小
+ */
+void flog_rb_commit(flog_ring_buffer_t *rb, uint32_t size)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    uint32_t free = flog_rb_get_free(rb);
+    if (size > free)
+    {
+        flog_rb_read_skip(rb, size - free);
+    }
+    flog_rb_write_skip(rb, size);
+}
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+
+#ifdef FLEXILOG_USE_FRAMED_RING_BUFFER
+/**
+ * @brief 丢弃最旧的整条记录, 直到剩余空间足够
+ * @param rb 环形缓冲区
+ * @param size 需要的剩余空间, 不能超过缓冲区大小
+ */
+static void flog_rb_drop_records(flog_ring_buffer_t *rb, uint32_t size)
+{
+    flog_rb_record_t head;
+    while (flog_rb_get_free(rb) < size)
+    {
+        flog_rb_peek(rb, 0, (char *)&head, sizeof(head));
+        flog_rb_read_skip(rb, sizeof(head) + head.length);
+    }
+}
+
+/**
+ * @brief 写入一条记录
+ * @note  空间不足时按整条记录丢弃最旧的数据, 不会残留半条记录
+ * @param rb 环形缓冲区
+ * @param data 日志
+ * @param size 日志长度
+ * @param level 日志等级
+ * @param target 日志所属的视图掩码
+ * @param sequence 日志序号
+ */
+void flog_rb_write_record(flog_ring_buffer_t *rb, const char *data, uint32_t size, uint8_t level, uint8_t target, uint32_t sequence)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flexlog_assert(data);
+    flog_rb_record_t head;
+    if (rb->size <= sizeof(head))
+    {
+        return;
+    }
+    if (size > rb->size - sizeof(head))
+    {
+        size = rb->size - sizeof(head);
+    }
+    if (size > UINT16_MAX)
+    {
+        size = UINT16_MAX;
+    }
+
+    flog_rb_drop_records(rb, sizeof(head) + size);
+
+    head.length = (uint16_t)size;
+    head.level = level;
+    head.target = target;
+    head.sequence = sequence;
+    flog_rb_write_force(rb, (const char *)&head, sizeof(head));
+    flog_rb_write_force(rb, data, size);
+}
+
+#ifdef FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+/**
+ * @brief 预留一条记录的写入空间
+ * @note  预留时不丢弃数据, 只保存被覆盖的旧记录的边界, 写入会覆盖它们的记录头; 提交时按实际长度丢弃整条记录
+ * @note  上一行剩余的边界仍然有效时从最后一个边界继续查找, 缓冲区写满后每行通常只需要读取一个记录头
+ * @note  覆盖的旧记录超过FLOG_RB_RESERVE_BOUND_MAX条时不预留, 调用者改用行缓冲区写入; 返回的空间不包含记录头
+ * @note  预留到提交期间不能读取缓冲区, 调用者需要持有日志锁
+ * @param rb 环形缓冲区
+ * @param size 需要的数据大小, 超过单条记录的上限时按上限预留
+ * @param span 返回的空间, 最多两段, 按顺序写入
+ * @return 空间段数
+ */
+uint32_t flog_rb_reserve_record(flog_ring_buffer_t *rb, uint32_t size, flog_rb_span_t span[2])
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flexlog_assert(span);
+    flog_rb_record_t head;
+    uint32_t free = flog_rb_get_free(rb);
+    uint32_t offset = 0;
+    if (flog_rb_reserve_cache.rb != rb)
+    {
+        flog_rb_reserve_cache.rb = rb;
+        flog_rb_reserve_cache.num = 0;
+    }
+    if (rb->size <= sizeof(head))
+    {
+        return flog_rb_span(rb, 0, 0, span);
+    }
+    if (size > rb->size - sizeof(head))
+    {
+        size = rb->size - sizeof(head);
+    }
+    if (size > UINT16_MAX)
+    {
+        size = UINT16_MAX;
+    }
+    /* 写入会覆盖旧记录的记录头, 先保存它们的边界 */
+    if (flog_rb_reserve_cache.num > 0)
+    {
+        offset = flog_rb_reserve_bound(flog_rb_reserve_cache.num - 1);
+    }
+    while (free + offset < sizeof(head) + size)
+    {
+        if (flog_rb_reserve_cache.num >= FLOG_RB_RESERVE_BOUND_MAX)
+        {
+            return flog_rb_span(rb, 0, 0, span);
+        }
+        flog_rb_peek(rb, offset, (char *)&head, sizeof(head));
+        offset += sizeof(head) + head.length;
+        flog_rb_reserve_cache.bound[(flog_rb_reserve_cache.first + flog_rb_reserve_cache.num++) % FLOG_RB_RESERVE_BOUND_MAX] = offset + flog_rb_reserve_cache.base;
+    }
+    return flog_rb_span(rb, flog_rb_write_index_at(rb, sizeof(head)), size, span);
+}
+
+/**
+ * @brief 提交预留的记录
+ * @param rb 环形缓冲区
+ * @param size 实际写入的数据大小, 不能超过预留的大小
+ * @param level 日志等级
+ * @param target 日志所属的视图掩码
+ * @param sequence 日志序号
+ */
+void flog_rb_commit_record(flog_ring_buffer_t *rb, uint32_t size, uint8_t level, uint8_t target, uint32_t sequence)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flog_rb_record_t head;
+    uint32_t free = flog_rb_get_free(rb);
+    uint32_t drop = 0;
+
+    /* 按预留时保存的边界丢弃与实际写入重叠的整条记录, 剩余的边界随读指针平移后留给下一行 */
+    for (uint32_t i = 0; i < flog_rb_reserve_cache.num && free + drop < sizeof(head) + size; ++i)
+    {
+        drop = flog_rb_reserve_bound(i);
+    }
+    flog_rb_read_skip(rb, drop);
+
+    head.length = (uint16_t)size;
+    head.level = level;
+    head.target = target;
+    head.sequence = sequence;
+    flog_rb_write_force(rb, (const char *)&head, sizeof(head));
+    flog_rb_write_skip(rb, size);
+}
+#endif // FLEXILOG_USE_ZERO_COPY_RING_BUFFER
+
+/**
+ * @brief 拷贝一条记录的文本
+ * @note  二进制记录通过渲染函数转换为文本, 没有渲染函数时按原样拷贝
+ * @param rb 环形缓冲区
+ * @param offset 记录头相对读指针的偏移
+ * @param head 记录头
+ * @param data 数据缓冲区
+ * @param size 数据缓冲区剩余大小
+ * @param render 二进制记录的渲染函数, 可以为NULL
+ * @return 拷贝的字节大小, 空间不足时返回FLOG_RB_NO_SPACE
+ */
+static uint32_t flog_rb_copy_record(flog_ring_buffer_t *rb, uint32_t offset, const flog_rb_record_t *head,
+                                    char *data, uint32_t size, flog_rb_render_t render)
+{
+    static char record[FLEXILOG_LINE_MAX_LENGTH];   // 调用者持有日志锁
+    uint32_t text_size = 0;
+    if ((head->target & FLOG_RB_RECORD_BINARY) && render != NULL)
+    {
+        if (head->length > sizeof(record))
+        {
+            return 0;
+        }
+        flog_rb_peek(rb, offset + sizeof(*head), record, head->length);
+        text_size = render(head, record, data, size);
+        return (text_size >= size) ? FLOG_RB_NO_SPACE : text_size;
+    }
+    if (head->length >= size)
+    {
+        return FLOG_RB_NO_SPACE;
+    }
+    flog_rb_peek(rb, offset + sizeof(*head), data, head->length);
+    return head->length;
+}
+
+/**
+ * @brief 读取整条记录
+ * @note  按记录头跳转, 不需要逐字节查找换行符
+ * @param rb 环形缓冲区
+ * @param data 数据缓冲区
+ * @param size 数据缓冲区大小
+ * @param render 二进制记录的渲染函数, 可以为NULL
+ * @return 读取的字节大小
+ */
+uint32_t flog_rb_read_records(flog_ring_buffer_t *rb, char *data, uint32_t size, flog_rb_render_t render)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flexlog_assert(data);
+    flog_rb_record_t head;
+    uint32_t read_size = 0;
+    uint32_t copy_size = 0;
+    while (flog_rb_get_used(rb) >= sizeof(head) && read_size < size)
+    {
+        flog_rb_peek(rb, 0, (char *)&head, sizeof(head));
+        copy_size = flog_rb_copy_record(rb, 0, &head, data + read_size, size - read_size, render);
+        if (copy_size == FLOG_RB_NO_SPACE)
         {
-            rb->buffer[rb->write_pos] = data[i];
-            rb->write_pos = (rb->write_pos + 1) % rb->size;
+            break;
         }
-        if (rb->read_pos == rb->write_pos)
+        flog_rb_read_skip(rb, sizeof(head) + head.length);
+        read_size += copy_size;
+    }
+    return read_size;
+}
+
+#ifdef FLEXILOG_USE_SHARED_RING_BUFFER
+/**
+ * @brief 初始化视图
+ * @param view 视图
+ * @param target 视图掩码, 记录的掩码与之有交集时可见
+ * @param level 只读取该等级的记录, FLOG_RB_VIEW_ANY_LEVEL表示不过滤
+ */
+void flog_rb_view_init(flog_rb_view_t *view, uint8_t target, uint8_t level)
+{
+    flexlog_assert(view);
+    view->target = target;
+    view->level = level;
+    view->sequence = 0;
+}
+
+/**
+ * @brief 通过视图读取整条记录
+ * @note  不会移动共享存储的读指针, 只移动视图自己的序号游标
+ * @param rb 共享存储
+ * @param view 视图
+ * @param data 数据缓冲区
+ * @param size 数据缓冲区大小
+ * @param render 二进制记录的渲染函数, 可以为NULL
+ * @return 读取的字节大小
+ */
+uint32_t flog_rb_read_view(flog_ring_buffer_t *rb, flog_rb_view_t *view, char *data, uint32_t size, flog_rb_render_t render)
+{
+    flexlog_assert(rb);
+    flexlog_assert(rb->buffer);
+    flexlog_assert(view);
+    flexlog_assert(data);
+    flog_rb_record_t head;
+    const uint32_t used = flog_rb_get_used(rb);
+    uint32_t offset = 0;
+    uint32_t read_size = 0;
+    uint32_t copy_size = 0;
+    while (used - offset >= sizeof(head) && read_size < size)
+    {
+        flog_rb_peek(rb, offset, (char *)&head, sizeof(head));
+        /* 跳过视图已经读过的记录 */
+        if ((int32_t)(head.sequence - view->sequence) >= 0)
         {
-            rb->write_pos_mirror = !rb->write_pos_mirror;
+            if ((head.target & view->target)
+                && (view->level == FLOG_RB_VIEW_ANY_LEVEL || head.level == view->level))
+            {
+                copy_size = flog_rb_copy_record(rb, offset, &head, data + read_size, size - read_size, render);
+                if (copy_size == FLOG_RB_NO_SPACE)
+                {
+                    break;
+                }
+                read_size += copy_size;
+            }
+            view->sequence = head.sequence + 1;
         }
+        offset += sizeof(head) + head.length;
     }
+    return read_size;
 }
-#endif //FLEXILOG_USE_RING_BUFFER
+#endif // FLEXILOG_USE_SHARED_RING_BUFFER
+#endif // FLEXILOG_USE_FRAMED_RING_BUFFER
+#endif // FLEXILOG_USE_RING_BUFFER || FLEXILOG_USE_ASYNC_OUTPUT
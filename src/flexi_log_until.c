@@ -10,6 +10,28 @@
  */
 #include "flexi_log_until.h"
 #include "flexi_log.h"
+#include "string.h"
+
+/* 两位十进制查找表, 每次转换两位 */
+static const char flog_decimal_pairs[200] =
+{
+    '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+    '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+    '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+    '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+    '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+    '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+    '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+    '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+    '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+    '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9',
+};
+
+/* 十六进制字符表 */
+static const char flog_hex_digits[16] =
+{
+    '0','1','2','3','4','5','6','7','8','9','A','B','C','D','E','F',
+};
 
 /**
  * @brief 字符串拼接
@@ -57,15 +79,103 @@ bool flog_strcmp(const char *str1, const char *str2)
 {
     flexlog_assert(str1 != NULL)
     flexlog_assert(str2 != NULL)
-    if (flog_strlen(str1) != flog_strlen(str2))
-        return false;
+    while (*str1 && *str1 == *str2)
+    {
+        str1++;
+        str2++;
+    }
+    return *str1 == *str2;
+}
+
+/**
+ * @brief 字符串哈希(FNV-1a)
+ * @param str 字符串
+ * @param max_len 参与计算的最大长度
+ * @return 哈希值
+ */
+uint32_t flog_strhash(const char *str, uint32_t max_len)
+{
+    flexlog_assert(str != NULL)
+    uint32_t hash = 2166136261U;
+    while (max_len-- && *str)
+    {
+        hash ^= (uint8_t)*str++;
+        hash *= 16777619U;
+    }
+    return hash;
+}
+
+/**
+ * @brief 无符号整数转十进制字符串
+ * @note  不添加结束符, dest至少10字节
+ * @param dest 目标位置
+ * @param value 数值
+ * @return 写入长度
+ */
+uint32_t flog_utoa(char *dest, uint32_t value)
+{
+    char digits[10];
+    uint32_t pos = sizeof(digits);
+    while (value >= 100)
+    {
+        uint32_t pair = (value % 100) * 2;
+        value /= 100;
+        digits[--pos] = flog_decimal_pairs[pair + 1];
+        digits[--pos] = flog_decimal_pairs[pair];
+    }
+    if (value >= 10)
+    {
+        digits[--pos] = flog_decimal_pairs[value * 2 + 1];
+        digits[--pos] = flog_decimal_pairs[value * 2];
+    }
+    else
+    {
+        digits[--pos] = (char)('0' + value);
+    }
+    memcpy(dest, digits + pos, sizeof(digits) - pos);
+    return sizeof(digits) - pos;
+}
 
-    while (*str1 && *str2)
+/**
+ * @brief 有符号整数转十进制字符串
+ * @note  不添加结束符, dest至少11字节
+ * @param dest 目标位置
+ * @param value 数值
+ * @return 写入长度
+ */
+uint32_t flog_itoa(char *dest, int32_t value)
+{
+    if (value < 0)
+    {
+        *dest = '-';
+        return flog_utoa(dest + 1, 0U - (uint32_t)value) + 1;
+    }
+    return flog_utoa(dest, (uint32_t)value);
+}
+
+/**
+ * @brief 字节转两位大写十六进制
+ * @note  不添加结束符
+ * @param dest 目标位置, 至少2字节
+ * @param value 数值
+ */
+void flog_hex8(char *dest, uint8_t value)
+{
+    dest[0] = flog_hex_digits[value >> 4];
+    dest[1] = flog_hex_digits[value & 0x0F];
+}
+
+/**
+ * @brief 32位数转8位大写十六进制
+ * @note  不添加结束符
+ * @param dest 目标位置, 至少8字节
+ * @param value 数值
+ */
+void flog_hex32(char *dest, uint32_t value)
+{
+    for (int i = 7; i >= 0; --i)
     {
-        if (*str1++ != *str2++)
-        {
-            return false;
-        }
+        dest[i] = flog_hex_digits[value & 0x0F];
+        value >>= 4;
     }
-    return true;
 }